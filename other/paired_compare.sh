@@ -0,0 +1,75 @@
+#!/bin/bash
+
+# Paired comparison of two noxim configurations (common random numbers):
+# both configurations are simulated with the same seeds, so that they are
+# offered the same traffic, and the per-seed differences B - A of the
+# global average delay and of the network throughput are averaged.
+# Usage: ./paired_compare.sh N_SEEDS "ARGS_A" "ARGS_B"
+# e.g.   ./paired_compare.sh 10 "-routing xy" "-routing west_last"
+
+NOXIM=${NOXIM:-./noxim}
+OUT_FOLDER=paired_out
+
+if [ $# -ne 3 ]
+then
+    echo "Usage: $0 N_SEEDS \"ARGS_A\" \"ARGS_B\""
+    exit 1
+fi
+
+N=$1
+ARGS_A=$2
+ARGS_B=$3
+
+mkdir -p $OUT_FOLDER
+rm -f $OUT_FOLDER/differences
+
+value()
+{
+    grep "^% $2" "$1" | head -n 1 | sed 's/.*: //'
+}
+
+for SEED in $(seq 1 $N)
+do
+    $NOXIM -seed $SEED $ARGS_A > $OUT_FOLDER/a_$SEED 2>&1 || { echo "Seed $SEED: configuration A failed"; exit 1; }
+    $NOXIM -seed $SEED $ARGS_B > $OUT_FOLDER/b_$SEED 2>&1 || { echo "Seed $SEED: configuration B failed"; exit 1; }
+
+    SIGNATURE_A=$(value $OUT_FOLDER/a_$SEED "Offered traffic signature")
+    SIGNATURE_B=$(value $OUT_FOLDER/b_$SEED "Offered traffic signature")
+    if [ -z "$SIGNATURE_A" ] || [ -z "$SIGNATURE_B" ]
+    then
+        echo "Seed $SEED: warning, no offered traffic signature to compare"
+    elif [ "$SIGNATURE_A" != "$SIGNATURE_B" ]
+    then
+        echo "Seed $SEED: warning, the configurations were offered different traffic ($SIGNATURE_A, $SIGNATURE_B)"
+    fi
+
+    DELAY_A=$(value $OUT_FOLDER/a_$SEED "Global average delay")
+    DELAY_B=$(value $OUT_FOLDER/b_$SEED "Global average delay")
+    THROUGHPUT_A=$(value $OUT_FOLDER/a_$SEED "Network throughput")
+    THROUGHPUT_B=$(value $OUT_FOLDER/b_$SEED "Network throughput")
+
+    echo "Seed $SEED: delay $DELAY_A $DELAY_B, throughput $THROUGHPUT_A $THROUGHPUT_B"
+    echo "$DELAY_A $DELAY_B $THROUGHPUT_A $THROUGHPUT_B" >> $OUT_FOLDER/differences
+done
+
+# mean, standard deviation and 95% confidence interval (normal
+# approximation, 1.96 standard errors) of the paired differences
+awk '
+{
+    d = $2 - $1; t = $4 - $3
+    sd += d; sdd += d * d
+    st += t; stt += t * t
+    n++
+}
+END {
+    md = sd / n; mt = st / n
+    vd = (n > 1) ? (sdd - n * md * md) / (n - 1) : 0
+    vt = (n > 1) ? (stt - n * mt * mt) / (n - 1) : 0
+    if (vd < 0) vd = 0
+    if (vt < 0) vt = 0
+    hd = 1.96 * sqrt(vd / n); ht = 1.96 * sqrt(vt / n)
+    print ""
+    print "Paired differences (B - A) over " n " seeds:"
+    printf "Global average delay (cycles): mean %g, std dev %g, 95%% CI [%g, %g]\n", md, sqrt(vd), md - hd, md + hd
+    printf "Network throughput (flits/cycle): mean %g, std dev %g, 95%% CI [%g, %g]\n", mt, sqrt(vt), mt - ht, mt + ht
+}' $OUT_FOLDER/differences
@@ -0,0 +1,250 @@
+// Converts a text packet trace into the binary trace replayed by noxim
+// with -traffic replay FILE.
+//
+// Each line of the text trace is a packet:
+//
+//   cycle src dst size [dep]
+//
+// where dep is the line (counting packets from 0, comments excluded)
+// of a packet which must be delivered before this one is injected.
+// Lines starting with % are comments. The packets of each source must
+// be sorted by cycle.
+//
+// The trace is read twice and never held in memory, so it can be
+// larger than the RAM. The records of each source are buffered and
+// written at their offsets through a single descriptor, whatever the
+// number of sources.
+
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+// Binary layout, must match src/TraceReplay.h
+
+#define TRACE_MAGIC		"NXTR"
+#define TRACE_VERSION		1
+#define TRACE_NO_DEPENDENCY	0xFFFFFFFF
+
+struct TraceHeader {
+  char     magic[4];
+  uint32_t version;
+  uint32_t n_sources;
+  uint32_t n_ids;
+  uint64_t n_records;
+};
+
+struct TraceIndex {
+  uint64_t first;
+  uint64_t count;
+};
+
+struct TraceRecord {
+  uint64_t cycle;
+  uint32_t id;
+  uint32_t dep_id;
+  uint32_t src;
+  uint32_t dst;
+  uint32_t size;
+  uint32_t reserved;
+};
+
+// Records buffered per source before being written
+#define RECORDS_PER_WRITE	64
+
+// ---------------------------------------------------------------------------
+// Global vars
+unsigned int   n_nodes;
+char           *trace_fname;
+char           *bin_fname;
+
+// ---------------------------------------------------------------------------
+
+// Reads the next packet of the trace. Returns false at the end of file
+bool ReadRecord(FILE *fin, TraceRecord& r)
+{
+  char line[256];
+
+  while (fgets(line, sizeof(line), fin) != NULL)
+    {
+      if (line[0] == '%' || line[0] == '\n')
+	continue;
+
+      unsigned long long cycle;
+      long dep = -1;
+      int n = sscanf(line, "%llu%u%u%u%ld", &cycle, &r.src, &r.dst, &r.size, &dep);
+      if (n < 4)
+	{
+	  cerr << "Invalid line: " << line << endl;
+	  exit(1);
+	}
+
+      r.cycle    = cycle;
+      r.dep_id   = (dep < 0) ? TRACE_NO_DEPENDENCY : (uint32_t)dep;
+      r.reserved = 0;
+      return true;
+    }
+
+  return false;
+}
+
+// Writes the buffered records of a source at its next offset and
+// empties the buffer
+bool FlushSource(int fd, vector<TraceRecord>& buffer, off_t& offset)
+{
+  size_t bytes = buffer.size() * sizeof(TraceRecord);
+  const char *data = (const char *)&buffer[0];
+
+  while (bytes > 0)
+    {
+      ssize_t written = pwrite(fd, data, bytes, offset);
+      if (written <= 0)
+	return false;
+      data   += written;
+      bytes  -= written;
+      offset += written;
+    }
+
+  buffer.clear();
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+
+void ParseCmdLine(int argc, char* argv[])
+{
+  if (argc != 4)
+    {
+      cerr << "Usage " << argv[0] << " <number of nodes> <text trace> <binary trace>" << endl;
+      exit(1);
+    }
+
+  n_nodes = atoi(argv[1]);
+  trace_fname = argv[2];
+  bin_fname = argv[3];
+}
+
+// ---------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  ParseCmdLine(argc, argv);
+
+  FILE *fin = fopen(trace_fname, "r");
+  if (fin == NULL)
+    {
+      cerr << "Cannot open " << trace_fname << endl;
+      return 1;
+    }
+
+  // 1st pass: records of each source
+  vector<TraceIndex> index(n_nodes);
+  vector<uint64_t>   last_cycle(n_nodes, 0);
+  uint64_t           n_records = 0;
+  TraceRecord        r;
+
+  for (unsigned int s = 0; s < n_nodes; s++)
+    index[s].count = 0;
+
+  while (ReadRecord(fin, r))
+    {
+      if (r.src >= n_nodes || r.dst >= n_nodes || r.src == r.dst || r.size < 2)
+	{
+	  cerr << "Invalid packet " << n_records << ": src " << r.src << ", dst " << r.dst << ", size " << r.size << endl;
+	  return 1;
+	}
+      if (index[r.src].count > 0 && r.cycle < last_cycle[r.src])
+	{
+	  cerr << "Packet " << n_records << " of source " << r.src << " is not sorted by cycle" << endl;
+	  return 1;
+	}
+      if (r.dep_id != TRACE_NO_DEPENDENCY && r.dep_id >= n_records)
+	{
+	  cerr << "Packet " << n_records << " depends on a later packet" << endl;
+	  return 1;
+	}
+
+      last_cycle[r.src] = r.cycle;
+      index[r.src].count++;
+      n_records++;
+    }
+
+  if (n_records > 0x7FFFFFFF)
+    {
+      cerr << "Too many packets, ids are limited to 31 bits" << endl;
+      return 1;
+    }
+
+  uint64_t first = 0;
+  for (unsigned int s = 0; s < n_nodes; s++)
+    {
+      index[s].first = first;
+      first += index[s].count;
+    }
+
+  // header and index
+  FILE *fout = fopen(bin_fname, "w+b");
+  if (fout == NULL)
+    {
+      cerr << "Cannot create " << bin_fname << endl;
+      return 1;
+    }
+
+  TraceHeader header;
+  memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+  header.version   = TRACE_VERSION;
+  header.n_sources = n_nodes;
+  header.n_ids     = n_records;
+  header.n_records = n_records;
+  fwrite(&header, sizeof(header), 1, fout);
+  fwrite(&index[0], sizeof(TraceIndex), n_nodes, fout);
+  fclose(fout);
+
+  // 2nd pass: the records of each source are written at its own offset
+  int fd = open(bin_fname, O_WRONLY);
+  if (fd < 0)
+    {
+      cerr << "Cannot open " << bin_fname << endl;
+      return 1;
+    }
+
+  off_t records_offset = sizeof(TraceHeader) + (off_t)n_nodes * sizeof(TraceIndex);
+  vector<off_t> offset(n_nodes);
+  vector< vector<TraceRecord> > buffer(n_nodes);
+  for (unsigned int s = 0; s < n_nodes; s++)
+    offset[s] = records_offset + (off_t)index[s].first * sizeof(TraceRecord);
+
+  bool ok = true;
+  rewind(fin);
+  uint32_t id = 0;
+  while (ok && ReadRecord(fin, r))
+    {
+      r.id = id++;
+      buffer[r.src].push_back(r);
+      if (buffer[r.src].size() == RECORDS_PER_WRITE)
+	ok = FlushSource(fd, buffer[r.src], offset[r.src]);
+    }
+
+  for (unsigned int s = 0; s < n_nodes && ok; s++)
+    if (!buffer[s].empty())
+      ok = FlushSource(fd, buffer[s], offset[s]);
+
+  ok = (close(fd) == 0) && ok;
+  fclose(fin);
+
+  if (!ok)
+    {
+      cerr << "Cannot write " << bin_fname << endl;
+      return 1;
+    }
+
+  cout << n_records << " packets of " << n_nodes << " sources written to " << bin_fname << endl;
+
+  return 0;
+}
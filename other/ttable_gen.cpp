@@ -0,0 +1,174 @@
+// Generates the traffic table of a mesh as the union of traffic
+// patterns, in the text format of the traffic tables or in the binary
+// format noxim loads without parsing (-traffic table FILE accepts
+// both). The patterns are the ones of the traffic_table_patterns
+// configuration parameter, generated by the same code
+// (src/TrafficTableGenerator.cpp).
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "../src/TrafficTableGenerator.h"
+
+using namespace std;
+
+// ---------------------------------------------------------------------------
+
+void HelpMessage(char *fname)
+{
+  cerr << "Usage: " << fname << " dim_x dim_y output [-binary] [-seed N] pattern [pattern ...]" << endl
+       << endl
+       << "Where \"output\" is the table file (- for the standard output, text only) and pattern is one of:" << endl
+       << "\tuniform RATE\t\t\tevery node to every other one, RATE packets/cycle per node" << endl
+       << "\thotspot RATE FRACTION N[,N...]\tas uniform, FRACTION of the rate to the hotspot nodes" << endl
+       << "\ttranspose1 RATE, transpose2 RATE, bitreversal RATE, shuffle RATE, butterfly RATE" << endl
+       << "\tregions PROB SRC_TL SRC_BR DST_TL DST_BR PIR_MIN PIR_MAX" << endl
+       << "\t\t\t\t\teach pair between the two regions with probability PROB (as hotspot_ttable)" << endl
+       << "\tdistance N DISTANCE SHORT_FRACTION PIR" << endl
+       << "\t\t\t\t\tN random pairs, SHORT_FRACTION within DISTANCE hops (as distancebased_ttable)" << endl
+       << endl
+       << "Example:" << endl
+       << fname << " 32 32 uniform.bin -binary uniform 0.01" << endl
+       << fname << " 8 8 - uniform 0.005 hotspot 0.005 0.5 0,63" << endl;
+}
+
+// comma separated list of integers, e.g. 0,7,63
+vector<int> ParseNodes(const char *list)
+{
+  vector<int> nodes;
+  string s(list);
+  size_t start = 0;
+
+  while (start <= s.size())
+    {
+      size_t end = s.find(',', start);
+      if (end == string::npos)
+	end = s.size();
+      nodes.push_back(atoi(s.substr(start, end - start).c_str()));
+      start = end + 1;
+    }
+
+  return nodes;
+}
+
+// Reads the pattern starting at argv[i], leaving i on its last argument.
+// Returns false on a wrong number of arguments
+bool ParsePattern(int argc, char **argv, int &i, TrafficPattern &p)
+{
+  p.pattern = argv[i];
+
+  int n_args;
+  if (p.pattern == PATTERN_HOTSPOT)
+    n_args = 3;
+  else if (p.pattern == PATTERN_REGIONS)
+    n_args = 7;
+  else if (p.pattern == PATTERN_DISTANCE)
+    n_args = 4;
+  else
+    n_args = 1;
+
+  if (i + n_args >= argc)
+    return false;
+
+  if (p.pattern == PATTERN_HOTSPOT)
+    {
+      p.rate = atof(argv[++i]);
+      p.fraction = atof(argv[++i]);
+      p.nodes = ParseNodes(argv[++i]);
+    }
+  else if (p.pattern == PATTERN_REGIONS)
+    {
+      p.fraction = atof(argv[++i]);
+      p.src_region.push_back(atoi(argv[++i]));
+      p.src_region.push_back(atoi(argv[++i]));
+      p.dst_region.push_back(atoi(argv[++i]));
+      p.dst_region.push_back(atoi(argv[++i]));
+      p.rate = atof(argv[++i]);
+      p.rate_max = atof(argv[++i]);
+    }
+  else if (p.pattern == PATTERN_DISTANCE)
+    {
+      p.communications = atoi(argv[++i]);
+      p.distance = atoi(argv[++i]);
+      p.fraction = atof(argv[++i]);
+      p.rate = atof(argv[++i]);
+    }
+  else
+    p.rate = atof(argv[++i]);
+
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  if (argc < 5)
+    {
+      HelpMessage(argv[0]);
+      return 1;
+    }
+
+  int dim_x = atoi(argv[1]);
+  int dim_y = atoi(argv[2]);
+  char *output = argv[3];
+  bool binary = false;
+  unsigned int seed = time(NULL);
+  vector<TrafficPattern> patterns;
+
+  for (int i = 4; i < argc; i++)
+    {
+      if (!strcmp(argv[i], "-binary"))
+	binary = true;
+      else if (!strcmp(argv[i], "-seed") && i + 1 < argc)
+	seed = atoi(argv[++i]);
+      else
+	{
+	  TrafficPattern p;
+	  if (!ParsePattern(argc, argv, i, p))
+	    {
+	      HelpMessage(argv[0]);
+	      return 1;
+	    }
+	  patterns.push_back(p);
+	}
+    }
+
+  if (dim_x < 1 || dim_y < 1 || patterns.empty() || (binary && !strcmp(output, "-")))
+    {
+      HelpMessage(argv[0]);
+      return 1;
+    }
+
+  srand(seed);
+
+  TrafficTableGenerator generator(dim_x, dim_y);
+  for (unsigned int i = 0; i < patterns.size(); i++)
+    if (!generator.add(patterns[i]))
+      return 1;
+
+  if (binary)
+    return generator.writeBinary(output) ? 0 : 1;
+
+  if (!strcmp(output, "-"))
+    generator.writeText(cout);
+  else
+    {
+      ofstream fout(output);
+      if (!fout)
+	{
+	  cerr << "Cannot create " << output << endl;
+	  return 1;
+	}
+      generator.writeText(fout);
+    }
+
+  cerr << generator.getTable().size() << " communications written" << endl;
+
+  return 0;
+}
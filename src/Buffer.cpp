@@ -11,8 +11,69 @@
 #include "Buffer.h"
 #include "Utils.h"
 
+BufferPool::BufferPool()
+{
+  configure(0, 0);
+}
+
+void BufferPool::configure(const int min_slots, const int shared_slots)
+{
+  this->min_slots = min_slots;
+  this->shared_slots = shared_slots;
+  shared_used = 0;
+}
+
+bool BufferPool::canAccept(const int occupancy) const
+{
+  return occupancy < min_slots || shared_used < shared_slots;
+}
+
+void BufferPool::acquire(const int occupancy)
+{
+  assert(canAccept(occupancy));
+
+  if (occupancy >= min_slots)
+    shared_used++;
+}
+
+void BufferPool::release(const int occupancy)
+{
+  if (occupancy >= min_slots)
+    shared_used--;
+
+  assert(shared_used >= 0);
+}
+
+int BufferPool::getFreeSlots(const int occupancy) const
+{
+  return max(0, min_slots - occupancy) + shared_slots - shared_used;
+}
+
+int BufferPool::getMaxSlots() const
+{
+  return min_slots + shared_slots;
+}
+
+BufferPool routerInputPool()
+{
+  BufferPool pool;
+
+  if (GlobalParams::buffer_organization == BUFFER_DAMQ)
+  {
+    // same total storage as the static organization
+    int slots = GlobalParams::buffer_depth * GlobalParams::n_virtual_channels;
+    int reserved = GlobalParams::damq_min_slots * GlobalParams::n_virtual_channels;
+    pool.configure(GlobalParams::damq_min_slots, slots - reserved);
+  }
+  else
+    pool.configure(GlobalParams::buffer_depth, 0);
+
+  return pool;
+}
+
 Buffer::Buffer()
 {
+  pool = NULL;
   SetMaxBufferSize(GlobalParams::buffer_depth);
   max_occupancy = 0;
   hold_time = 0.0;
@@ -127,6 +188,11 @@ void Buffer::Disable()
   true_buffer = false;
 }
 
+void Buffer::setPool(BufferPool * p)
+{
+  pool = p;
+}
+
 void Buffer::SetMaxBufferSize(const unsigned int bms)
 {
   assert(bms > 0);
@@ -136,11 +202,17 @@ void Buffer::SetMaxBufferSize(const unsigned int bms)
 
 unsigned int Buffer::GetMaxBufferSize() const
 {
+  if (pool != NULL)
+    return pool->getMaxSlots();
+
   return max_buffer_size;
 }
 
 bool Buffer::IsFull() const
 {
+  if (pool != NULL)
+    return !pool->canAccept(buffer.size());
+
   return buffer.size() == max_buffer_size;
 }
 
@@ -165,8 +237,11 @@ void Buffer::Push(const Flit & flit)
 
   if (IsFull())
     Drop(flit);
-  else
+  else {
+    if (pool != NULL)
+      pool->acquire(buffer.size());
     buffer.push(flit);
+  }
   
   UpdateMeanOccupancy();
 
@@ -185,6 +260,8 @@ Flit Buffer::Pop()
   else {
     f = buffer.front();
     buffer.pop();
+    if (pool != NULL)
+      pool->release(buffer.size());
   }
 
   UpdateMeanOccupancy();
@@ -211,6 +288,9 @@ unsigned int Buffer::Size() const
 
 unsigned int Buffer::getCurrentFreeSlots() const
 {
+  if (pool != NULL)
+    return pool->getFreeSlots(Size());
+
   return (GetMaxBufferSize() - Size());
 }
 
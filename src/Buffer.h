@@ -16,6 +16,41 @@
 #include "DataStructs.h"
 using namespace std;
 
+// Slots of an input port. With STATIC buffers each VC owns all its
+// slots; with DAMQ buffers each VC owns min_slots slots and takes the
+// remaining ones on demand from a pool shared by all the VCs of the port
+class BufferPool {
+
+  public:
+
+    BufferPool();
+
+    void configure(const int min_slots, const int shared_slots);
+
+    // True when a VC holding occupancy flits can store one more flit
+    bool canAccept(const int occupancy) const;
+
+    // A flit is stored in a VC holding occupancy flits
+    void acquire(const int occupancy);
+
+    // A flit is removed from a VC, leaving occupancy flits in it
+    void release(const int occupancy);
+
+    // Flits that can still be stored in a VC holding occupancy flits
+    int getFreeSlots(const int occupancy) const;
+
+    int getMaxSlots() const;
+
+  private:
+
+    int min_slots;
+    int shared_slots;
+    int shared_used;
+};
+
+// Slots of a router input port, according to buffer_organization
+BufferPool routerInputPool();
+
 class Buffer {
 
   public:
@@ -49,6 +84,8 @@ class Buffer {
 
     void Disable();
 
+    void setPool(BufferPool * p);	// Share the slots of p (DAMQ)
+
 
     void Print();
     
@@ -70,6 +107,7 @@ class Buffer {
     string label;
 
     unsigned int max_buffer_size;
+    BufferPool * pool;		// Shared slots, NULL for private buffers
 
     queue < Flit > buffer;
 
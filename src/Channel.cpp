@@ -28,16 +28,53 @@ void Channel::b_transport( int id, tlm::tlm_generic_payload& trans, sc_time& del
 	// Modify address within transaction
 	trans.set_address( masked_address );
 
+	// a multicast flit is heard by every hub owning some destination
+	struct Flit* f = (struct Flit*)trans.get_data_ptr();
+	vector<unsigned int> targets;
+	if (f->dst_set.any())
+	    targets = multicastTargets(*f);
+	else
+	    targets.push_back(target_nr);
+
+	// a sleeping destination must be woken up to receive the flit,
+	// paying the receiver wake-up latency
+	for (unsigned int t = 0; t < targets.size(); t++)
+	    if (GlobalParams::use_powermanager && hubs[targets[t]]->power.isSleeping())
+	    {
+		LOG << " HUB_"<<hubs_id[targets[t]]<<" woken up by an incoming flit" << endl;
+		delay += sc_time(hubs[targets[t]]->rxWakeUp() * GlobalParams::clock_period_ps, SC_PS);
+	    }
 
 	accountWirelessRxPower();
 
-	powerManager(target_nr,trans);
+	if (!f->dst_set.any())
+	    powerManager(target_nr,trans);
 
 	// Realize the delay annotated onto the transport call
 	wait(delay);
 
+	// CRC check at the receiver: a corrupted flit is NACKed and
+	// retransmitted by the hub, until the retry limit is reached
+	if (flitCorrupted())
+	{
+	    if (consecutive_errors[id] < GlobalParams::wireless_retry_limit)
+	    {
+		consecutive_errors[id]++;
+		LOG << " Flit " << *((struct Flit*)trans.get_data_ptr()) << " corrupted, sending NACK (" << consecutive_errors[id] << ")" << endl;
+		trans.set_response_status( tlm::TLM_GENERIC_ERROR_RESPONSE );
+		trans.set_address( address );
+		return;
+	    }
+	    LOG << " Flit " << *((struct Flit*)trans.get_data_ptr()) << " corrupted, retry limit reached " << endl;
+	    hubs[target_nr]->wireless_residual_errors++;
+	}
+	consecutive_errors[id] = 0;
+
 	// Forward transaction to appropriate target
-	init_socket[target_nr]->b_transport(trans, delay);
+	if (f->dst_set.any())
+	    multicastTransport(trans, delay, targets);
+	else
+	    init_socket[target_nr]->b_transport(trans, delay);
 
 
 	// Replace original address
@@ -46,6 +83,185 @@ void Channel::b_transport( int id, tlm::tlm_generic_payload& trans, sc_time& del
 }
 
 
+vector<unsigned int> Channel::multicastTargets(const Flit & flit)
+{
+    vector<unsigned int> targets;
+
+    for (unsigned int t = 0; t < hubs.size(); t++)
+    {
+	vector<int> & nodes = GlobalParams::hub_configuration[hubs_id[t]].attachedNodes;
+
+	for (unsigned int k = 0; k < nodes.size(); k++)
+	    if (flit.dst_set[nodes[k]])
+	    {
+		targets.push_back(t);
+		break;
+	    }
+    }
+
+    return targets;
+}
+
+void Channel::multicastTransport(tlm::tlm_generic_payload& trans, sc_time& delay, const vector<unsigned int> & targets)
+{
+    // the flit is delivered to all the targets or to none of them, so
+    // that a retransmission never duplicates it
+    for (unsigned int t = 0; t < targets.size(); t++)
+	if (hubs[targets[t]]->target[local_id]->buffer_rx.IsFull())
+	{
+	    LOG << " HUB_" << hubs_id[targets[t]] << " buffer_rx full, multicast flit not delivered" << endl;
+	    return;
+	}
+
+    unsigned char * data = trans.get_data_ptr();
+    Flit flit = *((struct Flit*)data);
+
+    for (unsigned int t = 0; t < targets.size(); t++)
+    {
+	// each hub receives the destinations attached to it
+	Flit copy = flit;
+	copy.dst_set.reset();
+
+	vector<int> & nodes = GlobalParams::hub_configuration[hubs_id[targets[t]]].attachedNodes;
+	for (unsigned int k = 0; k < nodes.size(); k++)
+	    if (flit.dst_set[nodes[k]])
+		copy.dst_set.set(nodes[k]);
+	copy.dst_id = firstDestination(copy.dst_set);
+
+	trans.set_data_ptr(reinterpret_cast<unsigned char*>(&copy));
+	init_socket[targets[t]]->b_transport(trans, delay);
+    }
+
+    trans.set_data_ptr(data);
+}
+
+bool Channel::flitCorrupted()
+{
+    pair<double, double> ber = GlobalParams::channel_configuration[local_id].ber;
+
+    if (ber.second == 0) return false;
+
+    double flit_ber = ber.first + (ber.second - ber.first) * ((double)rand() / RAND_MAX);
+
+    // probability that at least one bit of the flit is wrong
+    double p = 1.0 - pow(1.0 - flit_ber, GlobalParams::flit_size);
+
+    return ((double)rand() / RAND_MAX) < p;
+}
+
+
+pair<double, double> Channel::hubPosition(int hub_id)
+{
+    HubConfig & hub_config = GlobalParams::hub_configuration[hub_id];
+
+    if (hub_config.position.size() == 2)
+	return make_pair(hub_config.position[0], hub_config.position[1]);
+
+    // by default the hub is placed at the centroid of its tiles
+    double x = 0.0, y = 0.0;
+    int n = hub_config.attachedNodes.size();
+
+    for (int i = 0; i < n; i++)
+    {
+	Coord c = id2Coord(hub_config.attachedNodes[i]);
+	x += c.x;
+	y += c.y;
+    }
+
+    if (n == 0) return make_pair(0.0, 0.0);
+
+    return make_pair(x / n * GlobalParams::r2r_link_length, y / n * GlobalParams::r2r_link_length);
+}
+
+double Channel::pathLoss(int src_hub, int dst_hub)
+{
+    // measured attenuations, when available, override the distance model
+    map<pair<int, int>, double> & attenuation = GlobalParams::power_configuration.hubPowerConfig.transmitter_attenuation_map;
+    map<pair<int, int>, double>::iterator it = attenuation.find(make_pair(src_hub, dst_hub));
+
+    if (it != attenuation.end())
+	return it->second;
+
+    pair<double, double> src = hubPosition(src_hub);
+    pair<double, double> dst = hubPosition(dst_hub);
+    double distance = sqrt(pow(src.first - dst.first, 2) + pow(src.second - dst.second, 2));
+
+    // log-distance model referred to 1 mm
+    return GlobalParams::wireless_path_loss_1mm +
+	10.0 * GlobalParams::wireless_path_loss_exponent * log10(max(distance, 1.0));
+}
+
+double Channel::receivedPower(int src_hub, int dst_hub)
+{
+    // dBm -> mW
+    double dbm = GlobalParams::hub_configuration[src_hub].txPower - pathLoss(src_hub, dst_hub);
+    return pow(10.0, dbm / 10.0);
+}
+
+double Channel::sinr(int src_hub, int dst_hub, const map<int, int> & transmissions)
+{
+    double interference = pow(10.0, GlobalParams::wireless_noise_floor / 10.0);
+
+    for (map<int, int>::const_iterator it = transmissions.begin(); it != transmissions.end(); ++it)
+	if (it->first != src_hub)
+	    interference += receivedPower(it->first, dst_hub);
+
+    return 10.0 * log10(receivedPower(src_hub, dst_hub) / interference);
+}
+
+void Channel::updateConcurrencyStats()
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    if (!active_transmissions.empty())
+    {
+	concurrency_cycles += active_transmissions.size() * (now - last_update_cycle);
+	busy_cycles += now - last_update_cycle;
+    }
+    last_update_cycle = now;
+}
+
+bool Channel::requestTransmission(int src_hub, int dst_hub)
+{
+    map<int, int>::iterator it = active_transmissions.find(src_hub);
+    if (it != active_transmissions.end())
+	return it->second == dst_hub;
+
+    // half duplex transceivers, each receiver decodes a single
+    // transmission at a time
+    for (it = active_transmissions.begin(); it != active_transmissions.end(); ++it)
+	if (it->second == dst_hub || it->second == src_hub || it->first == dst_hub)
+	{
+	    deferred_requests++;
+	    return false;
+	}
+
+    map<int, int> transmissions = active_transmissions;
+    transmissions[src_hub] = dst_hub;
+
+    for (it = transmissions.begin(); it != transmissions.end(); ++it)
+	if (sinr(it->first, it->second, transmissions) < GlobalParams::wireless_sinr_threshold)
+	{
+	    LOG << " HUB_" << src_hub << " -> HUB_" << dst_hub << " deferred, SINR of HUB_" << it->first << " -> HUB_" << it->second << " would be " << sinr(it->first, it->second, transmissions) << " dB" << endl;
+	    deferred_requests++;
+	    return false;
+	}
+
+    updateConcurrencyStats();
+    active_transmissions[src_hub] = dst_hub;
+    granted_transmissions++;
+
+    LOG << " HUB_" << src_hub << " -> HUB_" << dst_hub << " granted, " << active_transmissions.size() << " concurrent transmissions" << endl;
+    return true;
+}
+
+void Channel::releaseTransmission(int src_hub)
+{
+    updateConcurrencyStats();
+    active_transmissions.erase(src_hub);
+}
+
+
 void Channel::accountWirelessRxPower()
 {
     for (unsigned int i = 0; i<hubs.size();i++)
@@ -63,20 +279,38 @@ void Channel::powerManager(unsigned int hub_dst_index, tlm::tlm_generic_payload&
 {
     if (!GlobalParams::use_powermanager) return;
 
+    // with spatial reuse any hub may be receiving a concurrent
+    // transmission, so nobody can be put to sleep
+    if (GlobalParams::channel_configuration[local_id].macPolicy[0] == SPATIAL_REUSE) return;
+
     struct Flit* f = (struct Flit*)trans.get_data_ptr();
 
-    if (f->flit_type==FLIT_TYPE_HEAD)
+    int sleep_cycles;
+
+    if (GlobalParams::channel_configuration[local_id].macPolicy[0] == TOKEN_PACKET)
     {
-	int sleep_cycles = flit_transmission_cycles * f->sequence_length;
+	// the whole packet is sent before the token is released
+	if (f->flit_type!=FLIT_TYPE_HEAD) return;
 
-	for (unsigned int i = 0; i<hubs.size();i++)
-	{
+	sleep_cycles = flit_transmission_cycles * f->sequence_length;
+    }
+    else
+    {
+	// TOKEN_HOLD/TOKEN_MAX_HOLD: the packet can be interrupted when
+	// the token expires, so non destination hubs can only sleep for
+	// the remaining flits while the current holder keeps the token
+	assert(token_ring != NULL);
+	int remaining_flits = f->sequence_length - f->sequence_no;
+	sleep_cycles = min(flit_transmission_cycles * remaining_flits,
+			   token_ring->getTokenExpiration(local_id));
+    }
 
-	    if (i!=hub_dst_index) 
-	    {
-		hubs[i]->power.rxSleep(sleep_cycles);
-		LOG << " HUB_"<<hubs_id[i]<<" rxSleep() invoked with " << sleep_cycles << " cycles " << endl;
-	    }
+    for (unsigned int i = 0; i<hubs.size();i++)
+    {
+	if (i!=hub_dst_index) 
+	{
+	    hubs[i]->power.rxSleep(sleep_cycles);
+	    LOG << " HUB_"<<hubs_id[i]<<" rxSleep() invoked with " << sleep_cycles << " cycles " << endl;
 	}
     }
 
@@ -36,6 +36,7 @@ struct Channel: sc_module
 
     vector<int> hubs_id;
     vector<Hub*> hubs;
+    TokenRing * token_ring;
 
     void addHub(Hub*);
 
@@ -55,6 +56,12 @@ struct Channel: sc_module
   : sc_module(nm), targ_socket("targ_socket"), init_socket("init_socket")
   {
     local_id = id;
+    token_ring = NULL;
+    granted_transmissions = 0;
+    deferred_requests = 0;
+    concurrency_cycles = 0.0;
+    busy_cycles = 0.0;
+    last_update_cycle = 0.0;
     targ_socket.register_b_transport(       this, &Channel::b_transport);
     targ_socket.register_get_direct_mem_ptr(this, &Channel::get_direct_mem_ptr);
     targ_socket.register_transport_dbg(     this, &Channel::transport_dbg);
@@ -123,6 +130,17 @@ struct Channel: sc_module
 
   int getFlitTransmissionCycles() { return flit_transmission_cycles;}
 
+  // SPATIAL_REUSE MAC: src_hub may start sending a packet to dst_hub
+  // only if every ongoing transmission, the new one included, keeps
+  // its SINR above wireless_sinr_threshold
+  bool requestTransmission(int src_hub, int dst_hub);
+  void releaseTransmission(int src_hub);
+
+  int granted_transmissions;
+  int deferred_requests;     // requests refused because of interference
+  double concurrency_cycles; // sum over time of the active transmissions
+  double busy_cycles;        // cycles with at least one active transmission
+
     private:
       int flit_transmission_cycles;
       int cc_flit_transmission_delay_ps; // clock compliant
@@ -130,7 +148,26 @@ struct Channel: sc_module
   std::map <tlm::tlm_generic_payload*, unsigned int> m_id_map;
 
    void powerManager(unsigned int hub_dst_index, tlm::tlm_generic_payload& trans);
+
+   // multicast flits: hubs owning some of the destinations, and delivery
+   // of a copy to each of them within the same transmission
+   vector<unsigned int> multicastTargets(const Flit & flit);
+   void multicastTransport(tlm::tlm_generic_payload& trans, sc_time& delay, const vector<unsigned int> & targets);
    void accountWirelessRxPower();
+   bool flitCorrupted();
+
+   // consecutive NACKs sent to each initiator for its current flit
+   map<int, int> consecutive_errors;
+
+   // ongoing SPATIAL_REUSE transmissions: src hub -> dst hub
+   map<int, int> active_transmissions;
+   double last_update_cycle;
+   void updateConcurrencyStats();
+
+   static pair<double, double> hubPosition(int hub_id);
+   double pathLoss(int src_hub, int dst_hub);
+   double receivedPower(int src_hub, int dst_hub);
+   double sinr(int src_hub, int dst_hub, const map<int, int> & transmissions);
 
 };
 
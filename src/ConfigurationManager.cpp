@@ -67,17 +67,53 @@ void loadConfiguration() {
 
     GlobalParams::r2r_link_length = readParam<double>(config, "r2r_link_length");
     GlobalParams::r2h_link_length = readParam<double>(config, "r2h_link_length");
+    GlobalParams::flow_control = readParam<string>(config, "flow_control", FLOW_CONTROL_ABP);
+    GlobalParams::r2r_link_stages = readParam<int>(config, "r2r_link_stages", 0);
+    GlobalParams::r2h_link_stages = readParam<int>(config, "r2h_link_stages", 0);
+    GlobalParams::link_mm_per_cycle = readParam<double>(config, "link_mm_per_cycle", 1.0);
     GlobalParams::buffer_depth = readParam<int>(config, "buffer_depth");
+    GlobalParams::buffer_organization = readParam<string>(config, "buffer_organization", BUFFER_STATIC);
+    GlobalParams::router_architecture = readParam<string>(config, "router_architecture", ROUTER_BUFFERED);
+    GlobalParams::damq_min_slots = readParam<int>(config, "damq_min_slots", 1);
+    GlobalParams::router_power_gating = readParam<bool>(config, "router_power_gating", false);
+    GlobalParams::rpg_idle_threshold = readParam<int>(config, "rpg_idle_threshold", 4);
+    GlobalParams::rpg_wakeup_latency = readParam<int>(config, "rpg_wakeup_latency", 3);
+    GlobalParams::rpg_breakeven_cycles = readParam<int>(config, "rpg_breakeven_cycles", 10);
     GlobalParams::flit_size = readParam<int>(config, "flit_size");
     GlobalParams::min_packet_size = readParam<int>(config, "min_packet_size");
     GlobalParams::max_packet_size = readParam<int>(config, "max_packet_size");
     GlobalParams::routing_algorithm = readParam<string>(config, "routing_algorithm");
     GlobalParams::routing_table_filename = readParam<string>(config, "routing_table_filename"); 
+    GlobalParams::escape_routing = readParam<string>(config, "escape_routing", "XY");
     GlobalParams::selection_strategy = readParam<string>(config, "selection_strategy");
+    GlobalParams::rca_weight = readParam<double>(config, "rca_weight", 0.5);
+    GlobalParams::allocator = readParam<string>(config, "allocator", "RANDOM");
+    GlobalParams::islip_iterations = readParam<int>(config, "islip_iterations", 1);
+    GlobalParams::lookahead_routing = readParam<bool>(config, "lookahead_routing", false);
+    GlobalParams::qos_classes = readParam<int>(config, "qos_classes", 1);
+    GlobalParams::router_bypass = readParam<bool>(config, "router_bypass", false);
     GlobalParams::packet_injection_rate = readParam<double>(config, "packet_injection_rate");
     GlobalParams::probability_of_retransmission = readParam<double>(config, "probability_of_retransmission");
+    GlobalParams::injection_process = readParam<string>(config, "injection_process", INJECTION_BERNOULLI);
+    GlobalParams::mmpp_state_rates = readParam< vector<double> >(config, "mmpp_state_rates", vector<double>());
+    GlobalParams::mmpp_state_sojourn = readParam< vector<double> >(config, "mmpp_state_sojourn", vector<double>());
+    GlobalParams::hurst = readParam<double>(config, "hurst", 0.8);
+    GlobalParams::onoff_sources = readParam<int>(config, "onoff_sources", 16);
+    GlobalParams::onoff_mean_period = readParam<double>(config, "onoff_mean_period", 100.0);
+    GlobalParams::dma_burst = readParam<int>(config, "dma_burst", 16);
+    GlobalParams::source_queue_size = readParam<int>(config, "source_queue_size", 0);
+    GlobalParams::source_queue_policy = readParam<string>(config, "source_queue_policy", SOURCE_QUEUE_STALL);
     GlobalParams::traffic_distribution = readParam<string>(config, "traffic_distribution");
+    GlobalParams::multicast_rate = readParam<double>(config, "multicast_rate", 0.0);
+    GlobalParams::multicast_size = readParam<int>(config, "multicast_size", 0);
     GlobalParams::traffic_table_filename = readParam<string>(config, "traffic_table_filename");
+    GlobalParams::traffic_table_patterns = readParam< vector<TrafficPattern> >(config, "traffic_table_patterns", vector<TrafficPattern>());
+    GlobalParams::trace_replay_filename = readParam<string>(config, "trace_replay_filename", "");
+    GlobalParams::task_graph_filename = readParam<string>(config, "task_graph_filename", "");
+    GlobalParams::memory_controllers = readParam< vector<int> >(config, "memory_controllers", vector<int>());
+    GlobalParams::max_outstanding = readParam<int>(config, "max_outstanding", 4);
+    GlobalParams::reply_size = readParam<int>(config, "reply_size", 8);
+    GlobalParams::service_latency = readParam<int>(config, "service_latency", 20);
     GlobalParams::clock_period_ps = readParam<int>(config, "clock_period_ps");
     GlobalParams::simulation_time = readParam<int>(config, "simulation_time");
     GlobalParams::n_virtual_channels = readParam<int>(config, "n_virtual_channels");
@@ -91,7 +127,17 @@ void loadConfiguration() {
     GlobalParams::show_buffer_stats = readParam<bool>(config, "show_buffer_stats");
     GlobalParams::use_winoc = readParam<bool>(config, "use_winoc");
     GlobalParams::winoc_dst_hops = readParam<int>(config, "winoc_dst_hops",0);
+    GlobalParams::winoc_routing_policy = readParam<string>(config, "winoc_routing_policy", WINOC_ROUTING_STATIC);
     GlobalParams::use_powermanager = readParam<bool>(config, "use_wirxsleep");
+    GlobalParams::use_predictive_powermanager = readParam<bool>(config, "wirxsleep_predictive", false);
+    GlobalParams::wirxsleep_wakeup_latency = readParam<int>(config, "wirxsleep_wakeup_latency", 2);
+    GlobalParams::wirxsleep_confidence = readParam<double>(config, "wirxsleep_confidence", 0.9);
+    GlobalParams::wireless_retry_limit = readParam<int>(config, "wireless_retry_limit", 4);
+    GlobalParams::wireless_retry_timeout = readParam<int>(config, "wireless_retry_timeout", 2);
+    GlobalParams::wireless_sinr_threshold = readParam<double>(config, "wireless_sinr_threshold", 10.0);
+    GlobalParams::wireless_noise_floor = readParam<double>(config, "wireless_noise_floor", -80.0);
+    GlobalParams::wireless_path_loss_exponent = readParam<double>(config, "wireless_path_loss_exponent", 2.5);
+    GlobalParams::wireless_path_loss_1mm = readParam<double>(config, "wireless_path_loss_1mm", 30.0);
     
 
     set<int> channelSet;
@@ -197,13 +243,25 @@ void showHelp(char selfname[])
          << "\t-dimx N\t\t\tSet the mesh X dimension" << endl
          << "\t-dimy N\t\t\tSet the mesh Y dimension" << endl
          << "\t-buffer N\t\tSet the depth of router input buffers [flits]" << endl
+         << "\t-damq MIN\t\tShare the slots of each router input among its VCs, reserving MIN slots per VC" << endl
          << "\t-buffer_tt N\t\tSet the depth of hub buffers to tile [flits]" << endl
          << "\t-buffer_ft N\t\tSet the depth of hub buffers to tile [flits]" << endl
          << "\t-buffer_antenna N\tSet the depth of hub antenna buffers (RX/TX) [flits]" << endl
 	 << "\t-vc N\t\t\tNumber of virtual channels" << endl
+         << "\t-flow_control TYPE\tSet the link flow control to one of the following:" << endl
+         << "\t\tABP\t\tAlternating bit protocol, one flit in flight per link" << endl
+         << "\t\tCREDIT\t\tCredit based, over pipelined links" << endl
+         << "\t-link_stages R2R R2H\tSet the pipeline stages of router-router and router-hub links (0: from link length)" << endl
          << "\t-winoc\t\t\tEnable radio hub wireless transmission" << endl
          << "\t-winoc_dst_hops\t\t\tMax number of hops between target RadioHub and destination node" << endl
+         << "\t-winoc_routing TYPE\tSet the wireless vs wired path selection policy to one of the following:" << endl
+         << "\t\tSTATIC\t\tAlways use the radio hub when source and destination hubs are connected" << endl
+         << "\t\tADAPTIVE\tCompare estimated wireless (hub queues, token position) and wired (hops, congestion) latency per packet" << endl
          << "\t-wirxsleep\t\tEnable radio hub wireless power manager" << endl
+         << "\t-wirxsleep_predictive\tAlso sleep during idle windows predicted from past receptions (requires -wirxsleep)" << endl
+         << "\t-wirxsleep_wakeup N\tSet the receiver wake-up latency [cycles]" << endl
+         << "\t-wireless_retry N T\tRetransmit a corrupted wireless flit at most N times, waiting T cycles for the ACK" << endl
+         << "\t-wireless_sinr DB\tSet the minimum SINR [dB] of concurrent SPATIAL_REUSE transmissions" << endl
          << "\t-size Nmin Nmax\t\tSet the minimum and maximum packet size [flits]" << endl
          << "\t-flit N\t\t\tSet the flit size [bit]" << endl
          << "\t-topology TYPE\t\tSet the topology to one of the following:" << endl
@@ -218,16 +276,32 @@ void showHelp(char selfname[])
          << "\t\tNEGATIVE_FIRST\tNegative-First routing algorithm" << endl
          << "\t\tODD_EVEN\tOdd-Even routing algorithm" << endl
          << "\t\tDYAD T\t\tDyAD routing algorithm with threshold T" << endl
+         << "\t\tFULLY_ADAPTIVE E\tFully adaptive minimal routing, with VC 0 as escape VC routed by E (XY or ODD_EVEN)" << endl
          << "\t\tTABLE_BASED FILENAME\tRouting Table Based routing algorithm with table in the specified file" << endl
          << "\t-sel TYPE\t\tSet the selection strategy to one of the following:" << endl
          << "\t\tRANDOM\t\tRandom selection strategy" << endl
          << "\t\tBUFFER_LEVEL\tBuffer-Level Based selection strategy" << endl
          << "\t\tNOP\t\tNeighbors-on-Path selection strategy" << endl
+         << "\t\tRCA W\t\tRegional congestion-aware selection, weighting the remote congestion by W [0..1)" << endl
+         << "\t-alloc TYPE\t\tSet the switch allocator to one of the following:" << endl
+         << "\t\tRANDOM\t\tEach input forwards a random reservation among the current ones" << endl
+         << "\t\tINPUT_FIRST\tSeparable input-first round-robin allocator" << endl
+         << "\t\tOUTPUT_FIRST\tSeparable output-first round-robin allocator" << endl
+         << "\t\tISLIP N\t\tiSLIP allocator performing N iterations" << endl
+         << "\t\tAGE\t\tMost urgent QoS class first, then oldest packet first" << endl
+         << "\t-qos N\t\t\tSplit the VCs among N QoS classes (class taken from the 8th column of the traffic table)" << endl
+         << "\t-lookahead\t\tCompute the output port of each head flit one router ahead (mesh only)" << endl
+         << "\t-bypass\t\t\tLet flits arriving on idle inputs skip the input buffers" << endl
+         << "\t-deflection\t\tUse bufferless deflection routers (mesh, 1 VC, -buffer 1)" << endl
+         << "\t-rpg I W B\t\tPower gate routers idle for I cycles, with a wake-up latency of W cycles and a break-even time of B cycles (mesh only)" << endl
          <<	"\t-pir R TYPE\t\tSet the packet injection rate R [0..1] and the time distribution TYPE where TYPE is one of the following:" << endl
          << "\t\tpoisson\t\tMemory-less Poisson distribution" << endl
          << "\t\tburst R\t\tBurst distribution with given real burstness" << endl
          << "\t\tpareto on off r\tSelf-similar Pareto distribution with given real parameters (alfa-on alfa-off r)" << endl
          << "\t\tcustom R\tCustom distribution with given real probability of retransmission" << endl
+         << "\t\tmmpp F1,F2.. S1,S2..\tMarkov-modulated Poisson, state i injecting F_i times more and lasting S_i cycles on average" << endl
+         << "\t\tselfsimilar H N T\tN aggregated Pareto on/off sources with Hurst parameter H (0.5..1) and mean period T [cycles]" << endl
+         << "\t\tdma B\t\tPeriodic bursts of B back to back packets" << endl
          << "\t-traffic TYPE\t\tSet the spatial distribution of traffic to TYPE where TYPE is one of the following:" << endl
          << "\t\trandom\t\tRandom traffic distribution" << endl
          << "\t\tlocal L\t\tRandom traffic with a fraction L (0..1) of packets having a destination connected to the local hub, i.e. not using wireless" << endl
@@ -238,7 +312,13 @@ void showHelp(char selfname[])
          << "\t\tbutterfly\tButterfly traffic distribution" << endl
          << "\t\tshuffle\t\tShuffle traffic distribution" << endl
          <<	"\t\ttable FILENAME\tTraffic Table Based traffic distribution with table in the specified file" << endl
+         << "\t\tclosedloop N S L\tRequests to the memory controllers (-mc), at most N outstanding per PE, answered by replies of S flits after L cycles" << endl
+         << "\t\ttaskgraph FILENAME\tMessages of the application task graph in the specified file, sent as the tasks complete" << endl
+         << "\t\treplay FILENAME\tReplay the timestamped packets of the binary trace in the specified file (see other/trace2bin.cpp)" << endl
          << "\t-hs ID P\t\tAdd node ID to hotspot nodes, with percentage P (0..1) (Only for 'random' traffic)" << endl
+         << "\t-mc ID\t\t\tAdd node ID to the memory controllers (Only for 'closedloop' traffic)" << endl
+         << "\t-sqs N POLICY\t\tBound the source queue of each PE to N packets (0 for unbounded), a full queue stalls or drops the new packets (POLICY is stall or drop)" << endl
+         << "\t-multicast R N\t\tMake a fraction R (0..1) of the packets multicasts to N random nodes (0 for broadcasts)" << endl
          << "\t-warmup N\t\tStart to collect statistics after N cycles" << endl
          << "\t-seed N\t\t\tSet the seed of the random generator (default time())" << endl
          << "\t-detailed\t\tShow detailed statistics" << endl
@@ -263,18 +343,108 @@ void showConfig()
          << "- mesh_dim_x = " << GlobalParams::mesh_dim_x << endl
          << "- mesh_dim_y = " << GlobalParams::mesh_dim_y << endl
          << "- buffer_depth = " << GlobalParams::buffer_depth << endl
+         << "- buffer_organization = " << GlobalParams::buffer_organization << endl
+         << "- router_architecture = " << GlobalParams::router_architecture << endl
+         << "- router_power_gating = " << GlobalParams::router_power_gating << endl
+         << "- rpg_idle_threshold = " << GlobalParams::rpg_idle_threshold << endl
+         << "- rpg_wakeup_latency = " << GlobalParams::rpg_wakeup_latency << endl
+         << "- rpg_breakeven_cycles = " << GlobalParams::rpg_breakeven_cycles << endl
          << "- n_virtual_channels = " << GlobalParams::n_virtual_channels << endl
          << "- max_packet_size = " << GlobalParams::max_packet_size << endl
          << "- routing_algorithm = " << GlobalParams::routing_algorithm << endl
       // << "- routing_table_filename = " << GlobalParams::routing_table_filename << endl
          << "- selection_strategy = " << GlobalParams::selection_strategy << endl
+         << "- rca_weight = " << GlobalParams::rca_weight << endl
+         << "- allocator = " << GlobalParams::allocator << endl
+         << "- lookahead_routing = " << GlobalParams::lookahead_routing << endl
+         << "- router_bypass = " << GlobalParams::router_bypass << endl
+         << "- qos_classes = " << GlobalParams::qos_classes << endl
          << "- packet_injection_rate = " << GlobalParams::packet_injection_rate << endl
          << "- probability_of_retransmission = " << GlobalParams::probability_of_retransmission << endl
+         << "- injection_process = " << GlobalParams::injection_process << endl
+         << "- source_queue_size = " << GlobalParams::source_queue_size << endl
+         << "- source_queue_policy = " << GlobalParams::source_queue_policy << endl
          << "- traffic_distribution = " << GlobalParams::traffic_distribution << endl
+         << "- traffic_table_patterns = " << GlobalParams::traffic_table_patterns.size() << endl
+         << "- max_outstanding = " << GlobalParams::max_outstanding << endl
+         << "- reply_size = " << GlobalParams::reply_size << endl
+         << "- service_latency = " << GlobalParams::service_latency << endl
+         << "- multicast_rate = " << GlobalParams::multicast_rate << endl
+         << "- multicast_size = " << GlobalParams::multicast_size << endl
          << "- clock_period = " << GlobalParams::clock_period_ps << "ps" << endl
          << "- simulation_time = " << GlobalParams::simulation_time << endl
          << "- warm_up_time = " << GlobalParams::stats_warm_up_time << endl
          << "- rnd_generator_seed = " << GlobalParams::rnd_generator_seed << endl;
+
+    for (unsigned int i = 0; i < GlobalParams::traffic_profiles.size(); i++)
+    {
+	const TrafficProfile & profile = GlobalParams::traffic_profiles[i];
+	cout << "- traffic profile " << profile.name << ": "
+	     << profile.traffic_distribution << ", " << profile.injection_process
+	     << ", pir " << profile.packet_injection_rate;
+	if (profile.packet_sizes.empty())
+	    cout << ", sizes " << profile.min_packet_size << ".." << profile.max_packet_size << endl;
+	else
+	{
+	    cout << ", sizes";
+	    for (unsigned int s = 0; s < profile.packet_sizes.size(); s++)
+		cout << " " << profile.packet_sizes[s] << "(" << profile.packet_size_weights[s] << ")";
+	    cout << endl;
+	}
+    }
+}
+
+// Checks an injection process used at the given rate, by the global
+// parameters or by a traffic profile (owner prefixes the messages).
+// The parameters of the processes are shared, so they are checked
+// whenever a process is used
+static void checkInjectionProcess(const string & process, const double rate, const string & owner)
+{
+    if (process == INJECTION_MMPP) {
+	if (GlobalParams::mmpp_state_rates.empty() ||
+	    GlobalParams::mmpp_state_rates.size() != GlobalParams::mmpp_state_sojourn.size()) {
+	    cerr << "Error: " << owner << "MMPP needs the same number (> 0) of mmpp_state_rates and mmpp_state_sojourn" << endl;
+	    exit(1);
+	}
+	double weighted = 0.0, time = 0.0, max_rate = 0.0;
+	for (unsigned int s = 0; s < GlobalParams::mmpp_state_rates.size(); s++) {
+	    if (GlobalParams::mmpp_state_rates[s] < 0 || GlobalParams::mmpp_state_sojourn[s] < 1) {
+		cerr << "Error: " << owner << "MMPP state rates must be >= 0 and sojourn times >= 1 cycle" << endl;
+		exit(1);
+	    }
+	    weighted += GlobalParams::mmpp_state_rates[s] * GlobalParams::mmpp_state_sojourn[s];
+	    time += GlobalParams::mmpp_state_sojourn[s];
+	    max_rate = max(max_rate, GlobalParams::mmpp_state_rates[s]);
+	}
+	// see mmppStateRate()
+	if (weighted <= 0 || rate * max_rate * time / weighted > 1.0) {
+	    cerr << "Error: " << owner << "with this packet injection rate, the busiest MMPP state would inject more than a packet per cycle" << endl;
+	    exit(1);
+	}
+    }
+    else if (process == INJECTION_SELF_SIMILAR) {
+	if (GlobalParams::hurst <= 0.5 || GlobalParams::hurst >= 1.0 ||
+	    GlobalParams::onoff_sources < 1 || GlobalParams::onoff_mean_period < 1) {
+	    cerr << "Error: " << owner << "SELF_SIMILAR needs hurst in ]0.5,1[, onoff_sources >= 1 and onoff_mean_period >= 1" << endl;
+	    exit(1);
+	}
+	// while all the sources are on, each cycle injects with twice the mean rate
+	if (rate > 0.5) {
+	    cerr << "Error: " << owner << "SELF_SIMILAR injection needs a packet injection rate <= 0.5" << endl;
+	    exit(1);
+	}
+    }
+    else if (process == INJECTION_DMA) {
+	// the DMA period is dma_burst / rate
+	if (GlobalParams::dma_burst < 1 || rate <= 0.0) {
+	    cerr << "Error: " << owner << "DMA needs dma_burst >= 1 and a packet injection rate > 0" << endl;
+	    exit(1);
+	}
+    }
+    else if (process != INJECTION_BERNOULLI) {
+	cerr << "Error: " << owner << "invalid injection process " << process << endl;
+	exit(1);
+    }
 }
 
 void checkConfiguration()
@@ -329,10 +499,27 @@ void checkConfiguration()
 		}
 	}
 
+	if (GlobalParams::winoc_routing_policy != WINOC_ROUTING_STATIC &&
+		GlobalParams::winoc_routing_policy != WINOC_ROUTING_ADAPTIVE)
+	{
+		cerr << "Error: invalid winoc_routing_policy " << GlobalParams::winoc_routing_policy << endl;
+		exit(1);
+	}
+
     if (GlobalParams::buffer_depth < 1) {
 	cerr << "Error: buffer must be >= 1" << endl;
 	exit(1);
     }
+    if (GlobalParams::buffer_organization != BUFFER_STATIC &&
+	GlobalParams::buffer_organization != BUFFER_DAMQ) {
+	cerr << "Error: invalid buffer organization " << GlobalParams::buffer_organization << endl;
+	exit(1);
+    }
+    if (GlobalParams::buffer_organization == BUFFER_DAMQ &&
+	(GlobalParams::damq_min_slots < 1 || GlobalParams::damq_min_slots > GlobalParams::buffer_depth)) {
+	cerr << "Error: damq_min_slots must be in the range [1,buffer_depth]" << endl;
+	exit(1);
+    }
     if (GlobalParams::flit_size <= 0) {
 	cerr << "Error: flit_size must be > 0" << endl;
 	exit(1);
@@ -356,6 +543,99 @@ void checkConfiguration()
 	exit(1);
     }
 
+    if (GlobalParams::flow_control != FLOW_CONTROL_ABP &&
+	GlobalParams::flow_control != FLOW_CONTROL_CREDIT) {
+	cerr << "Error: invalid flow control " << GlobalParams::flow_control << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::r2r_link_stages < 0 || GlobalParams::r2h_link_stages < 0 ||
+	GlobalParams::link_mm_per_cycle <= 0) {
+	cerr << "Error: link stages must be >= 0 and link_mm_per_cycle > 0" << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::islip_iterations < 1) {
+	cerr << "Error: islip_iterations must be >= 1" << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::qos_classes < 1 ||
+	GlobalParams::qos_classes > GlobalParams::n_virtual_channels) {
+	cerr << "Error: qos_classes must be in the range [1," << GlobalParams::n_virtual_channels << "]" << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::routing_algorithm == ROUTING_FULLY_ADAPTIVE) {
+	if (GlobalParams::topology != TOPOLOGY_MESH || GlobalParams::n_virtual_channels < 2) {
+	    cerr << "Error: FULLY_ADAPTIVE routing requires a mesh topology and at least 2 virtual channels" << endl;
+	    exit(1);
+	}
+	if (GlobalParams::escape_routing != "XY" && GlobalParams::escape_routing != "ODD_EVEN") {
+	    cerr << "Error: the escape routing must be XY or ODD_EVEN" << endl;
+	    exit(1);
+	}
+	// the VCs are reallocated at each hop, regardless of classes and lookahead outputs
+	if (GlobalParams::qos_classes > 1 || GlobalParams::lookahead_routing) {
+	    cerr << "Error: FULLY_ADAPTIVE routing cannot be used with QoS classes or lookahead routing" << endl;
+	    exit(1);
+	}
+    }
+
+    if (GlobalParams::selection_strategy == "RCA") {
+	if (GlobalParams::topology != TOPOLOGY_MESH) {
+	    cerr << "Error: RCA selection strategy is only supported on mesh topologies" << endl;
+	    exit(1);
+	}
+	if (GlobalParams::rca_weight < 0 || GlobalParams::rca_weight >= 1) {
+	    cerr << "Error: rca_weight must be in the range [0,1)" << endl;
+	    exit(1);
+	}
+    }
+
+    if (GlobalParams::router_architecture != ROUTER_BUFFERED &&
+	GlobalParams::router_architecture != ROUTER_DEFLECTION) {
+	cerr << "Error: invalid router architecture " << GlobalParams::router_architecture << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::router_architecture == ROUTER_DEFLECTION) {
+	if (GlobalParams::topology != TOPOLOGY_MESH || GlobalParams::use_winoc) {
+	    cerr << "Error: DEFLECTION routers are only supported on wired mesh topologies" << endl;
+	    exit(1);
+	}
+	// the only storage is the single flit latch of each input
+	if (GlobalParams::buffer_depth != 1 || GlobalParams::n_virtual_channels != 1) {
+	    cerr << "Error: DEFLECTION routers are bufferless, use buffer_depth 1 and a single virtual channel" << endl;
+	    exit(1);
+	}
+	if (GlobalParams::flow_control != FLOW_CONTROL_ABP ||
+	    GlobalParams::routing_algorithm == ROUTING_FULLY_ADAPTIVE ||
+	    GlobalParams::lookahead_routing || GlobalParams::router_bypass) {
+	    cerr << "Error: DEFLECTION routers cannot be used with credits, FULLY_ADAPTIVE routing, lookahead or bypass" << endl;
+	    exit(1);
+	}
+    }
+
+    if (GlobalParams::router_power_gating) {
+	// the wake-up signal travels on the links to the mesh neighbors
+	if (GlobalParams::topology != TOPOLOGY_MESH || GlobalParams::flow_control != FLOW_CONTROL_ABP ||
+	    GlobalParams::router_architecture != ROUTER_BUFFERED) {
+	    cerr << "Error: router power gating requires buffered routers on a mesh with ABP flow control" << endl;
+	    exit(1);
+	}
+	if (GlobalParams::rpg_idle_threshold < 1 || GlobalParams::rpg_wakeup_latency < 0 ||
+	    GlobalParams::rpg_breakeven_cycles < 0) {
+	    cerr << "Error: rpg_idle_threshold must be >= 1, rpg_wakeup_latency and rpg_breakeven_cycles >= 0" << endl;
+	    exit(1);
+	}
+    }
+
+    if (GlobalParams::lookahead_routing && GlobalParams::topology != TOPOLOGY_MESH) {
+	cerr << "Error: lookahead routing is only supported on mesh topologies" << endl;
+	exit(1);
+    }
+
     if (GlobalParams::packet_injection_rate <= 0.0 ||
 	GlobalParams::packet_injection_rate > 1.0) {
 	cerr <<
@@ -364,6 +644,19 @@ void checkConfiguration()
 	exit(1);
     }
 
+    checkInjectionProcess(GlobalParams::injection_process, GlobalParams::packet_injection_rate, "");
+
+    if (GlobalParams::source_queue_size < 0) {
+	cerr << "Error: source_queue_size must be >= 0" << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::source_queue_policy != SOURCE_QUEUE_STALL &&
+	GlobalParams::source_queue_policy != SOURCE_QUEUE_DROP) {
+	cerr << "Error: invalid source queue policy " << GlobalParams::source_queue_policy << endl;
+	exit(1);
+    }
+
     for (unsigned int i = 0; i < GlobalParams::hotspots.size(); i++) {
 	if (GlobalParams::topology==TOPOLOGY_MESH){
 		if (GlobalParams::hotspots[i].first >=
@@ -390,6 +683,35 @@ void checkConfiguration()
 	}
     }
 
+    if (GlobalParams::traffic_distribution == TRAFFIC_CLOSED_LOOP) {
+	int n_nodes = (GlobalParams::topology == TOPOLOGY_MESH) ?
+	    GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y : GlobalParams::n_delta_tiles;
+
+	if (GlobalParams::memory_controllers.empty() ||
+	    (int)GlobalParams::memory_controllers.size() >= n_nodes) {
+	    cerr << "Error: closed-loop traffic needs at least a memory controller and a requester" << endl;
+	    exit(1);
+	}
+	for (unsigned int i = 0; i < GlobalParams::memory_controllers.size(); i++)
+	    if (GlobalParams::memory_controllers[i] < 0 || GlobalParams::memory_controllers[i] >= n_nodes) {
+		cerr << "Error: memory controller " << GlobalParams::memory_controllers[i] << " is invalid (out of range)" << endl;
+		exit(1);
+	    }
+	if (GlobalParams::max_outstanding < 1 || GlobalParams::reply_size < 2 || GlobalParams::service_latency < 0) {
+	    cerr << "Error: max_outstanding must be >= 1, reply_size >= 2 and service_latency >= 0" << endl;
+	    exit(1);
+	}
+    }
+
+    // transactions, messages and trace packets complete with their tail flit
+    if ((GlobalParams::traffic_distribution == TRAFFIC_CLOSED_LOOP ||
+	 GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH ||
+	 GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY) &&
+	GlobalParams::router_architecture == ROUTER_DEFLECTION) {
+	cerr << "Error: closed-loop, task graph and trace replay traffic cannot be used with DEFLECTION routers" << endl;
+	exit(1);
+    }
+
     if (GlobalParams::stats_warm_up_time < 0) {
 	cerr << "Error: warm-up time must be positive" << endl;
 	exit(1);
@@ -411,6 +733,36 @@ void checkConfiguration()
 	exit(1);
     }
 
+    if (GlobalParams::multicast_rate < 0 || GlobalParams::multicast_rate > 1)
+    {
+	cerr << "Error: multicast_rate must be in the range 0..1" << endl;
+	exit(1);
+    }
+
+    if (GlobalParams::multicast_rate > 0)
+    {
+	int n_nodes = GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y;
+
+	// destination sets are split along the XY tree
+	if (GlobalParams::topology != TOPOLOGY_MESH || GlobalParams::routing_algorithm != ROUTING_XY) {
+	    cerr << "Error: multicast packets require a mesh topology and XY routing" << endl;
+	    exit(1);
+	}
+	if (n_nodes > MAX_MULTICAST_NODES) {
+	    cerr << "Error: multicast packets support at most " << MAX_MULTICAST_NODES << " nodes" << endl;
+	    exit(1);
+	}
+	if (GlobalParams::multicast_size < 0 || GlobalParams::multicast_size >= n_nodes) {
+	    cerr << "Error: multicast_size must be in the range [0," << n_nodes - 1 << "]" << endl;
+	    exit(1);
+	}
+	if (GlobalParams::router_architecture == ROUTER_DEFLECTION ||
+	    GlobalParams::lookahead_routing || GlobalParams::router_bypass) {
+	    cerr << "Error: multicast packets cannot be used with DEFLECTION routers, lookahead or bypass" << endl;
+	    exit(1);
+	}
+    }
+
     if (GlobalParams::locality<0 || GlobalParams::locality>1)
     {
 	cerr << "Error: traffic locality must be in the range 0..1" << endl;
@@ -436,11 +788,54 @@ void checkConfiguration()
 	     << "GlobalParams.h and compile again " << endl;
 	exit(1);
     }
-    if (GlobalParams::n_virtual_channels>1 && GlobalParams::use_powermanager)
+    if (GlobalParams::use_predictive_powermanager && !GlobalParams::use_powermanager)
+    {
+	cerr << "Error: predictive power manager requires -wirxsleep" << endl;
+	exit(1);
+    }
+    if (GlobalParams::wirxsleep_wakeup_latency < 0)
+    {
+	cerr << "Error: wirxsleep_wakeup_latency must be >= 0" << endl;
+	exit(1);
+    }
+    if (GlobalParams::wirxsleep_confidence <= 0 || GlobalParams::wirxsleep_confidence >= 1)
+    {
+	cerr << "Error: wirxsleep_confidence must be in the interval ]0,1[" << endl;
+	exit(1);
+    }
+    if (GlobalParams::wireless_retry_limit < 0 || GlobalParams::wireless_retry_timeout < 0)
     {
-	cerr << "Error: Power manager (-wirxsleep) option only supports a single virtual channel" << endl;
+	cerr << "Error: wireless_retry_limit and wireless_retry_timeout must be >= 0" << endl;
 	exit(1);
     }
+    for (map<int, ChannelConfig>::iterator it = GlobalParams::channel_configuration.begin();
+	    it != GlobalParams::channel_configuration.end();
+	    ++it)
+    {
+	pair<double, double> ber = it->second.ber;
+	if (ber.first < 0 || ber.second > 1 || ber.first > ber.second)
+	{
+	    cerr << "Error: invalid ber range [" << ber.first << ", " << ber.second << "] for radio channel " << it->first << endl;
+	    exit(1);
+	}
+	// interference is evaluated towards a single receiver
+	if (it->second.macPolicy[0] == SPATIAL_REUSE && GlobalParams::multicast_rate > 0)
+	{
+	    cerr << "Error: multicast packets cannot be used with SPATIAL_REUSE on radio channel " << it->first << endl;
+	    exit(1);
+	}
+	if (it->second.macPolicy[0] == SPATIAL_REUSE && GlobalParams::topology != TOPOLOGY_MESH)
+	{
+	    for (map<int, HubConfig>::iterator hit = GlobalParams::hub_configuration.begin();
+		    hit != GlobalParams::hub_configuration.end();
+		    ++hit)
+		if (hit->second.position.size() != 2)
+		{
+		    cerr << "Error: SPATIAL_REUSE on radio channel " << it->first << " requires an explicit position for hub " << hit->first << endl;
+		    exit(1);
+		}
+	}
+    }
 
     if (GlobalParams::ascii_monitor)
     {
@@ -451,6 +846,142 @@ void checkConfiguration()
     }
 }
 
+static bool isSyntheticTraffic(const string & traffic)
+{
+    return traffic == TRAFFIC_RANDOM || traffic == TRAFFIC_TRANSPOSE1 ||
+	traffic == TRAFFIC_TRANSPOSE2 || traffic == TRAFFIC_BIT_REVERSAL ||
+	traffic == TRAFFIC_SHUFFLE || traffic == TRAFFIC_BUTTERFLY ||
+	traffic == TRAFFIC_LOCAL || traffic == TRAFFIC_ULOCAL;
+}
+
+static void checkTrafficProfile(const TrafficProfile & profile)
+{
+    if (!isSyntheticTraffic(profile.traffic_distribution)) {
+	cerr << "Error: traffic profile " << profile.name << ": " << profile.traffic_distribution
+	     << " is not a synthetic traffic distribution" << endl;
+	exit(1);
+    }
+
+    if (profile.packet_injection_rate <= 0.0 || profile.packet_injection_rate > 1.0) {
+	cerr << "Error: traffic profile " << profile.name << ": packet injection rate must be in the interval ]0,1]" << endl;
+	exit(1);
+    }
+
+    checkInjectionProcess(profile.injection_process, profile.packet_injection_rate,
+			  "traffic profile " + profile.name + ": ");
+
+    if (profile.min_packet_size < 2 || profile.min_packet_size > profile.max_packet_size) {
+	cerr << "Error: traffic profile " << profile.name << ": packet sizes must be >= 2 flits, min <= max" << endl;
+	exit(1);
+    }
+
+    if (profile.packet_sizes.size() != profile.packet_size_weights.size()) {
+	cerr << "Error: traffic profile " << profile.name << ": packet_sizes and packet_size_weights must have the same length" << endl;
+	exit(1);
+    }
+
+    double total_weight = 0.0;
+    for (unsigned int s = 0; s < profile.packet_sizes.size(); s++) {
+	if (profile.packet_sizes[s] < 2 || profile.packet_size_weights[s] < 0) {
+	    cerr << "Error: traffic profile " << profile.name << ": packet sizes must be >= 2 flits, their weights >= 0" << endl;
+	    exit(1);
+	}
+	total_weight += profile.packet_size_weights[s];
+    }
+    if (!profile.packet_sizes.empty() && total_weight <= 0) {
+	cerr << "Error: traffic profile " << profile.name << ": the packet size weights are all zero" << endl;
+	exit(1);
+    }
+}
+
+// Flattens the TrafficProfiles section into the profile of each node.
+// Nodes in no profile follow the global parameters; a node in several
+// profiles follows the last one
+void resolveTrafficProfiles()
+{
+    TrafficProfile & defaults = GlobalParams::default_traffic_profile;
+    defaults.name = "default";
+    defaults.packet_injection_rate = GlobalParams::packet_injection_rate;
+    defaults.probability_of_retransmission = GlobalParams::probability_of_retransmission;
+    defaults.injection_process = GlobalParams::injection_process;
+    defaults.traffic_distribution = GlobalParams::traffic_distribution;
+    defaults.min_packet_size = GlobalParams::min_packet_size;
+    defaults.max_packet_size = GlobalParams::max_packet_size;
+
+    int n_nodes = (GlobalParams::topology == TOPOLOGY_MESH) ?
+	GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y : GlobalParams::n_delta_tiles;
+    GlobalParams::node_traffic_profile.assign(n_nodes, defaults);
+    GlobalParams::traffic_profiles.clear();
+
+    if (!config["TrafficProfiles"])
+	return;
+
+    if (!isSyntheticTraffic(GlobalParams::traffic_distribution)) {
+	cerr << "Error: traffic profiles are only available with synthetic traffic distributions" << endl;
+	exit(1);
+    }
+
+    for (YAML::const_iterator profiles_it = config["TrafficProfiles"].begin();
+	 profiles_it != config["TrafficProfiles"].end();
+	 ++profiles_it)
+    {
+	TrafficProfile profile = profiles_it->second.as<TrafficProfile>();
+	profile.name = profiles_it->first.as<string>();
+	checkTrafficProfile(profile);
+
+	vector<int> nodes = profile.nodes;
+
+	if (!profile.region.empty()) {
+	    if (GlobalParams::topology != TOPOLOGY_MESH || profile.region.size() != 4) {
+		cerr << "Error: traffic profile " << profile.name << ": a region is [x0, y0, x1, y1] on a mesh" << endl;
+		exit(1);
+	    }
+	    for (int y = profile.region[1]; y <= profile.region[3]; y++)
+		for (int x = profile.region[0]; x <= profile.region[2]; x++) {
+		    if (x < 0 || y < 0 || x >= GlobalParams::mesh_dim_x || y >= GlobalParams::mesh_dim_y) {
+			cerr << "Error: traffic profile " << profile.name << ": region out of the mesh" << endl;
+			exit(1);
+		    }
+		    nodes.push_back(y * GlobalParams::mesh_dim_x + x);
+		}
+	}
+
+	if (nodes.empty()) {
+	    cerr << "Error: traffic profile " << profile.name << " applies to no node" << endl;
+	    exit(1);
+	}
+
+	for (unsigned int i = 0; i < nodes.size(); i++) {
+	    if (nodes[i] < 0 || nodes[i] >= n_nodes) {
+		cerr << "Error: traffic profile " << profile.name << ": node " << nodes[i] << " is invalid (out of range)" << endl;
+		exit(1);
+	    }
+	    GlobalParams::node_traffic_profile[nodes[i]] = profile;
+	}
+
+	GlobalParams::traffic_profiles.push_back(profile);
+    }
+}
+
+// comma separated list of reals, e.g. 1,8.5,2
+static vector<double> parseList(const char *list)
+{
+    vector<double> values;
+    string s(list);
+    size_t start = 0;
+
+    while (start <= s.size())
+    {
+	size_t end = s.find(',', start);
+	if (end == string::npos)
+	    end = s.size();
+	values.push_back(atof(s.substr(start, end - start).c_str()));
+	start = end + 1;
+    }
+
+    return values;
+}
+
 void parseCmdLine(int arg_num, char *arg_vet[])
 {
     if (arg_num == 1)
@@ -478,6 +1009,11 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 
 	    else if (!strcmp(arg_vet[i], "-buffer"))
 		GlobalParams::buffer_depth = atoi(arg_vet[++i]);
+	    else if (!strcmp(arg_vet[i], "-damq"))
+	    {
+		GlobalParams::buffer_organization = BUFFER_DAMQ;
+		GlobalParams::damq_min_slots = atoi(arg_vet[++i]);
+	    }
 	    else if (!strcmp(arg_vet[i], "-buffer_tt"))
 		setBufferToTile(atoi(arg_vet[++i]));
 	    else if (!strcmp(arg_vet[i], "-buffer_ft"))
@@ -486,6 +1022,13 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 		setBufferAntenna(atoi(arg_vet[++i]));
 	    else if (!strcmp(arg_vet[i], "-vc"))
 		GlobalParams::n_virtual_channels = (atoi(arg_vet[++i]));
+	    else if (!strcmp(arg_vet[i], "-flow_control"))
+		GlobalParams::flow_control = arg_vet[++i];
+	    else if (!strcmp(arg_vet[i], "-link_stages"))
+	    {
+		GlobalParams::r2r_link_stages = atoi(arg_vet[++i]);
+		GlobalParams::r2h_link_stages = atoi(arg_vet[++i]);
+	    }
 	    else if (!strcmp(arg_vet[i], "-flit"))
 		GlobalParams::flit_size = atoi(arg_vet[++i]);
 	    else if (!strcmp(arg_vet[i], "-winoc")) 
@@ -494,10 +1037,23 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 	    {
             GlobalParams::winoc_dst_hops = atoi(arg_vet[++i]);
 	    }
+	    else if (!strcmp(arg_vet[i], "-winoc_routing")) 
+		GlobalParams::winoc_routing_policy = arg_vet[++i];
 	    else if (!strcmp(arg_vet[i], "-wirxsleep")) 
 	    {
 		GlobalParams::use_powermanager = true;
 	    }
+	    else if (!strcmp(arg_vet[i], "-wirxsleep_predictive")) 
+		GlobalParams::use_predictive_powermanager = true;
+	    else if (!strcmp(arg_vet[i], "-wirxsleep_wakeup")) 
+		GlobalParams::wirxsleep_wakeup_latency = atoi(arg_vet[++i]);
+	    else if (!strcmp(arg_vet[i], "-wireless_retry")) 
+	    {
+		GlobalParams::wireless_retry_limit = atoi(arg_vet[++i]);
+		GlobalParams::wireless_retry_timeout = atoi(arg_vet[++i]);
+	    }
+	    else if (!strcmp(arg_vet[i], "-wireless_sinr")) 
+		GlobalParams::wireless_sinr_threshold = atof(arg_vet[++i]);
 	    else if (!strcmp(arg_vet[i], "-size")) 
 	    {
 		GlobalParams::min_packet_size = atoi(arg_vet[++i]);
@@ -513,6 +1069,8 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 		GlobalParams::routing_algorithm = arg_vet[++i];
 		if (GlobalParams::routing_algorithm == ROUTING_DYAD)
 		    GlobalParams::dyad_threshold = atof(arg_vet[++i]);
+		else if (GlobalParams::routing_algorithm == ROUTING_FULLY_ADAPTIVE)
+		    GlobalParams::escape_routing = arg_vet[++i];
 		else if (GlobalParams::routing_algorithm == ROUTING_TABLE_BASED) 
 		{
 		    GlobalParams::routing_table_filename = arg_vet[++i];
@@ -521,7 +1079,29 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 	    } 
 	    else if (!strcmp(arg_vet[i], "-sel")) {
 		GlobalParams::selection_strategy = arg_vet[++i];
+		if (GlobalParams::selection_strategy == "RCA")
+		    GlobalParams::rca_weight = atof(arg_vet[++i]);
+	    } 
+	    else if (!strcmp(arg_vet[i], "-alloc")) {
+		GlobalParams::allocator = arg_vet[++i];
+		if (GlobalParams::allocator == "ISLIP")
+		    GlobalParams::islip_iterations = atoi(arg_vet[++i]);
 	    } 
+	    else if (!strcmp(arg_vet[i], "-qos"))
+		GlobalParams::qos_classes = atoi(arg_vet[++i]);
+	    else if (!strcmp(arg_vet[i], "-lookahead"))
+		GlobalParams::lookahead_routing = true;
+	    else if (!strcmp(arg_vet[i], "-bypass"))
+		GlobalParams::router_bypass = true;
+	    else if (!strcmp(arg_vet[i], "-deflection"))
+		GlobalParams::router_architecture = ROUTER_DEFLECTION;
+	    else if (!strcmp(arg_vet[i], "-rpg"))
+	    {
+		GlobalParams::router_power_gating = true;
+		GlobalParams::rpg_idle_threshold = atoi(arg_vet[++i]);
+		GlobalParams::rpg_wakeup_latency = atoi(arg_vet[++i]);
+		GlobalParams::rpg_breakeven_cycles = atoi(arg_vet[++i]);
+	    }
 	    else if (!strcmp(arg_vet[i], "-pir")) 
 	    {
 		
@@ -545,6 +1125,21 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 		} 
 		else if (!strcmp(distribution, "custom"))
 		    GlobalParams::probability_of_retransmission = atof(arg_vet[++i]);
+		else if (!strcmp(distribution, "mmpp")) {
+		    GlobalParams::injection_process = INJECTION_MMPP;
+		    GlobalParams::mmpp_state_rates = parseList(arg_vet[++i]);
+		    GlobalParams::mmpp_state_sojourn = parseList(arg_vet[++i]);
+		}
+		else if (!strcmp(distribution, "selfsimilar")) {
+		    GlobalParams::injection_process = INJECTION_SELF_SIMILAR;
+		    GlobalParams::hurst = atof(arg_vet[++i]);
+		    GlobalParams::onoff_sources = atoi(arg_vet[++i]);
+		    GlobalParams::onoff_mean_period = atof(arg_vet[++i]);
+		}
+		else if (!strcmp(distribution, "dma")) {
+		    GlobalParams::injection_process = INJECTION_DMA;
+		    GlobalParams::dma_burst = atoi(arg_vet[++i]);
+		}
 		else assert("Invalid pir format" && false);
 	    } 
 	    else if (!strcmp(arg_vet[i], "-traffic")) 
@@ -573,6 +1168,17 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 		    GlobalParams::traffic_distribution =
 			TRAFFIC_TABLE_BASED;
 		    GlobalParams::traffic_table_filename = arg_vet[++i];
+		} else if (!strcmp(traffic, "closedloop")) {
+		    GlobalParams::traffic_distribution = TRAFFIC_CLOSED_LOOP;
+		    GlobalParams::max_outstanding = atoi(arg_vet[++i]);
+		    GlobalParams::reply_size = atoi(arg_vet[++i]);
+		    GlobalParams::service_latency = atoi(arg_vet[++i]);
+		} else if (!strcmp(traffic, "taskgraph")) {
+		    GlobalParams::traffic_distribution = TRAFFIC_TASK_GRAPH;
+		    GlobalParams::task_graph_filename = arg_vet[++i];
+		} else if (!strcmp(traffic, "replay")) {
+		    GlobalParams::traffic_distribution = TRAFFIC_TRACE_REPLAY;
+		    GlobalParams::trace_replay_filename = arg_vet[++i];
 		} else if (!strcmp(traffic, "local")) {
 		    GlobalParams::traffic_distribution = TRAFFIC_LOCAL;
 		    GlobalParams::locality=atof(arg_vet[++i]);
@@ -586,6 +1192,21 @@ void parseCmdLine(int arg_num, char *arg_vet[])
 		pair < int, double >t(node, percentage);
 		GlobalParams::hotspots.push_back(t);
 	    } 
+	    else if (!strcmp(arg_vet[i], "-mc"))
+		GlobalParams::memory_controllers.push_back(atoi(arg_vet[++i]));
+	    else if (!strcmp(arg_vet[i], "-sqs"))
+	    {
+		GlobalParams::source_queue_size = atoi(arg_vet[++i]);
+		char *policy = arg_vet[++i];
+		if (!strcmp(policy, "stall")) GlobalParams::source_queue_policy = SOURCE_QUEUE_STALL;
+		else if (!strcmp(policy, "drop")) GlobalParams::source_queue_policy = SOURCE_QUEUE_DROP;
+		else GlobalParams::source_queue_policy = policy;
+	    }
+	    else if (!strcmp(arg_vet[i], "-multicast"))
+	    {
+		GlobalParams::multicast_rate = atof(arg_vet[++i]);
+		GlobalParams::multicast_size = atoi(arg_vet[++i]);
+	    }
 	    else if (!strcmp(arg_vet[i], "-warmup"))
 		GlobalParams::stats_warm_up_time = atoi(arg_vet[++i]);
 	    else if (!strcmp(arg_vet[i], "-seed"))
@@ -671,6 +1292,7 @@ void configure(int arg_num, char *arg_vet[]) {
     parseCmdLine(arg_num, arg_vet);
 
     checkConfiguration();
+    resolveTrafficProfiles();
 
     // Show configuration
     if (GlobalParams::verbose_mode > VERBOSE_OFF)
@@ -42,6 +42,8 @@ namespace YAML {
             node["from_tile_buffer_size"] = hubConfig.fromTileBufferSize;
             node["tx_buffer_size"] = hubConfig.txBufferSize;
             node["rx_buffer_size"] = hubConfig.rxBufferSize;
+            node["position"] = hubConfig.position;
+            node["tx_power"] = hubConfig.txPower;
             return node;
         }
 
@@ -53,10 +55,77 @@ namespace YAML {
             hubConfig.fromTileBufferSize = node["from_tile_buffer_size"].as<int>(GlobalParams::default_hub_configuration.fromTileBufferSize);
             hubConfig.txBufferSize = node["tx_buffer_size"].as<int>(GlobalParams::default_hub_configuration.txBufferSize);
             hubConfig.rxBufferSize = node["rx_buffer_size"].as<int>(GlobalParams::default_hub_configuration.rxBufferSize);
+            hubConfig.position = node["position"].as<vector<double> >(GlobalParams::default_hub_configuration.position);
+            hubConfig.txPower = node["tx_power"].as<double>(GlobalParams::default_hub_configuration.txPower);
             return true;
         }
     };
     
+    template<>
+    struct convert<TrafficProfile> {
+        static Node encode(const TrafficProfile& profile) {
+            Node node;
+            node["nodes"] = profile.nodes;
+            node["region"] = profile.region;
+            node["packet_injection_rate"] = profile.packet_injection_rate;
+            node["probability_of_retransmission"] = profile.probability_of_retransmission;
+            node["injection_process"] = profile.injection_process;
+            node["traffic_distribution"] = profile.traffic_distribution;
+            node["min_packet_size"] = profile.min_packet_size;
+            node["max_packet_size"] = profile.max_packet_size;
+            node["packet_sizes"] = profile.packet_sizes;
+            node["packet_size_weights"] = profile.packet_size_weights;
+            return node;
+        }
+
+        static bool decode(const Node& node, TrafficProfile& profile) {
+            const TrafficProfile& defaults = GlobalParams::default_traffic_profile;
+            profile.nodes = node["nodes"].as<vector<int> >(vector<int>());
+            profile.region = node["region"].as<vector<int> >(vector<int>());
+            profile.packet_injection_rate = node["packet_injection_rate"].as<double>(defaults.packet_injection_rate);
+            // a profile giving its own rate retransmits at that rate, unless specified
+            profile.probability_of_retransmission = node["probability_of_retransmission"].as<double>(
+                node["packet_injection_rate"] ? profile.packet_injection_rate : defaults.probability_of_retransmission);
+            profile.injection_process = node["injection_process"].as<string>(defaults.injection_process);
+            profile.traffic_distribution = node["traffic_distribution"].as<string>(defaults.traffic_distribution);
+            profile.min_packet_size = node["min_packet_size"].as<int>(defaults.min_packet_size);
+            profile.max_packet_size = node["max_packet_size"].as<int>(defaults.max_packet_size);
+            profile.packet_sizes = node["packet_sizes"].as<vector<int> >(defaults.packet_sizes);
+            profile.packet_size_weights = node["packet_size_weights"].as<vector<double> >(defaults.packet_size_weights);
+            return true;
+        }
+    };
+
+    template<>
+    struct convert<TrafficPattern> {
+        static Node encode(const TrafficPattern& pattern) {
+            Node node;
+            node["pattern"] = pattern.pattern;
+            node["rate"] = pattern.rate;
+            node["rate_max"] = pattern.rate_max;
+            node["nodes"] = pattern.nodes;
+            node["fraction"] = pattern.fraction;
+            node["src_region"] = pattern.src_region;
+            node["dst_region"] = pattern.dst_region;
+            node["communications"] = pattern.communications;
+            node["distance"] = pattern.distance;
+            return node;
+        }
+
+        static bool decode(const Node& node, TrafficPattern& pattern) {
+            pattern.pattern = node["pattern"].as<string>("");
+            pattern.rate = node["rate"].as<double>(0.0);
+            pattern.rate_max = node["rate_max"].as<double>(pattern.rate);
+            pattern.nodes = node["nodes"].as<vector<int> >(vector<int>());
+            pattern.fraction = node["fraction"].as<double>(0.0);
+            pattern.src_region = node["src_region"].as<vector<int> >(vector<int>());
+            pattern.dst_region = node["dst_region"].as<vector<int> >(vector<int>());
+            pattern.communications = node["communications"].as<int>(0);
+            pattern.distance = node["distance"].as<int>(0);
+            return true;
+        }
+    };
+
     template<>
     struct convert<ChannelConfig> {
         static Node encode(const ChannelConfig& channelConfig) {
@@ -12,8 +12,12 @@
 #define _DATASTRUCS_H__
 
 #include <systemc.h>
+#include <bitset>
 #include "GlobalParams.h"
 
+// DestinationSet -- destinations of a multicast packet, one bit per node
+typedef bitset < MAX_MULTICAST_NODES > DestinationSet;
+
 // Coord -- XY coordinates type of the Tile inside the Mesh
 class Coord {
   public:
@@ -29,6 +33,11 @@ enum FlitType {
     FLIT_TYPE_HEAD, FLIT_TYPE_BODY, FLIT_TYPE_TAIL
 };
 
+// Role of a packet in closed-loop traffic
+enum TransactionType {
+    TRANSACTION_NONE, TRANSACTION_REQUEST, TRANSACTION_REPLY
+};
+
 // Payload -- Payload definition
 struct Payload {
     sc_uint<32> data;	// Bus for the data to be exchanged
@@ -46,9 +55,20 @@ struct Packet {
     int size;
     int flit_left;		// Number of remaining flits inside the packet
     bool use_low_voltage_path;
+    int traffic_class;		// QoS class, 0 being the most urgent
+    DestinationSet dst_set;	// Multicast destinations, empty for unicast packets
+    int trace_id;		// Packet id in the replayed trace, NOT_VALID otherwise
+    TransactionType transaction;	// Closed-loop traffic: request, reply or none
+    double request_timestamp;	// Generation of the request a reply answers
+    int task_edge;		// Task graph message the packet belongs to, NOT_VALID otherwise
+    double injection_timestamp;	// Cycle the head flit left the source queue
+    int packet_id;		// Sequence number among the packets injected by the source
 
-    // Constructors
-    Packet() { }
+    // Constructors: every field is initialised, the generators of the
+    // synthetic traffic only setting the ones they use
+    Packet() {
+	make(NOT_VALID, NOT_VALID, 0, 0.0, 0);
+    }
 
     Packet(const int s, const int d, const int vc, const double ts, const int sz) {
 	make(s, d, vc, ts, sz);
@@ -62,6 +82,14 @@ struct Packet {
 	size = sz;
 	flit_left = sz;
 	use_low_voltage_path = false;
+	traffic_class = 0;
+	dst_set.reset();
+	trace_id = NOT_VALID;
+	transaction = TRANSACTION_NONE;
+	request_timestamp = ts;
+	task_edge = NOT_VALID;
+	injection_timestamp = ts;
+	packet_id = NOT_VALID;
     }
 };
 
@@ -72,6 +100,7 @@ struct RouteData {
     int dst_id;
     int dir_in;			// direction from which the packet comes from
     int vc_id;
+    int packet_size;		// number of flits of the packet being routed
 };
 
 struct ChannelStatus {
@@ -84,10 +113,23 @@ struct ChannelStatus {
 
 // NoP_data -- NoP Data definition
 struct NoP_data {
+    NoP_data()
+    {
+	for (int i = 0; i < DIRECTIONS; i++)
+	    rca_load[i] = 0;
+    };
+
     int sender_id;
     ChannelStatus channel_status_neighbor[DIRECTIONS];
 
+    // Regional congestion (RCA selection): aggregated load, in per-mille
+    // of the buffering capacity, met by a packet that keeps travelling
+    // in direction i from the sender
+    int rca_load[DIRECTIONS];
+
     inline bool operator ==(const NoP_data & nop_data) const {
+	for (int i = 0; i < DIRECTIONS; i++)
+	    if (rca_load[i] != nop_data.rca_load[i]) return false;
 	return (sender_id == nop_data.sender_id &&
 		nop_data.channel_status_neighbor[0] ==
 		channel_status_neighbor[0]
@@ -105,14 +147,21 @@ struct TBufferFullStatus {
     {
 	for (int i=0;i<MAX_VIRTUAL_CHANNELS;i++)
 	    mask[i] = false;
+	credit_seq = 0;
+	credit_vc = 0;
     };
     inline bool operator ==(const TBufferFullStatus & bfs) const {
 	for (int i=0;i<MAX_VIRTUAL_CHANNELS;i++)
 	    if (mask[i] != bfs.mask[i]) return false;
-	return true;
+	return (credit_seq == bfs.credit_seq && credit_vc == bfs.credit_vc);
     };
    
     bool mask[MAX_VIRTUAL_CHANNELS];
+
+    // credit based flow control: credit_seq is incremented each time a
+    // slot of VC credit_vc is returned to the sender
+    int credit_seq;
+    int credit_vc;
 };
 
 // Flit -- Flit definition
@@ -127,8 +176,18 @@ struct Flit {
     double timestamp;		// Unix timestamp at packet generation
     int hop_no;			// Current number of hops from source to destination
     bool use_low_voltage_path;
+    int traffic_class;		// QoS class of the packet
 
     int hub_relay_node;
+    int lookahead_out;		// Output port at the next router (lookahead routing)
+    int deflections;		// Times the flit was sent away from its destination
+    DestinationSet dst_set;	// Multicast destinations served through this flit, empty for unicast
+    int trace_id;		// Packet id in the replayed trace, NOT_VALID otherwise
+    TransactionType transaction;	// Closed-loop traffic: request, reply or none
+    double request_timestamp;	// Generation of the request a reply answers
+    int task_edge;		// Task graph message the packet belongs to, NOT_VALID otherwise
+    double injection_timestamp;	// Cycle the head flit left the source queue
+    int packet_id;		// Sequence number among the packets injected by the source
 
     inline bool operator ==(const Flit & flit) const {
 	return (flit.src_id == src_id && flit.dst_id == dst_id
@@ -138,7 +197,8 @@ struct Flit {
 		&& flit.sequence_length == sequence_length
 		&& flit.payload == payload && flit.timestamp == timestamp
 		&& flit.hop_no == hop_no
-		&& flit.use_low_voltage_path == use_low_voltage_path);
+		&& flit.use_low_voltage_path == use_low_voltage_path
+		&& flit.dst_set == dst_set);
 }};
 
 
@@ -172,6 +232,7 @@ enum
     WIRELESS_TX,
     WIRELESS_DYNAMIC_RX_PWR,
     WIRELESS_SNOOPING,
+    POWER_GATING_PWR_D,
     NO_BREAKDOWN_ENTRIES_D
 };
 
@@ -0,0 +1,121 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the credit based flow control
+ */
+
+#include "FlowControl.h"
+
+int linkStages(int configured_stages, double length_mm)
+{
+    if (configured_stages > 0)
+	return configured_stages;
+
+    return max(1, (int)ceil(length_mm / GlobalParams::link_mm_per_cycle));
+}
+
+LinkReceiver::LinkReceiver()
+{
+    stages = 1;
+    reset();
+}
+
+void LinkReceiver::setStages(const int stages)
+{
+    assert(stages > 0);
+    this->stages = stages;
+}
+
+void LinkReceiver::reset()
+{
+    flits = queue<pair<double, Flit> >();
+    credits = queue<pair<double, int> >();
+    credit_seq = 0;
+    credit_vc = 0;
+}
+
+void LinkReceiver::receive(const Flit & flit)
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    // sampling the link already accounts for the first stage
+    flits.push(make_pair(now + stages - 1, flit));
+}
+
+bool LinkReceiver::flitArrived() const
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    return (!flits.empty() && flits.front().first <= now);
+}
+
+Flit LinkReceiver::popFlit()
+{
+    assert(!flits.empty());
+
+    Flit flit = flits.front().second;
+    flits.pop();
+
+    return flit;
+}
+
+void LinkReceiver::returnCredit(const int vc)
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    credits.push(make_pair(now + stages - 1, vc));
+}
+
+void LinkReceiver::writeCredit(TBufferFullStatus & bfs)
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    if (!credits.empty() && credits.front().first <= now)
+    {
+	credit_seq++;
+	credit_vc = credits.front().second;
+	credits.pop();
+    }
+
+    bfs.credit_seq = credit_seq;
+    bfs.credit_vc = credit_vc;
+}
+
+LinkSender::LinkSender()
+{
+    reset(BufferPool());
+}
+
+void LinkSender::reset(const BufferPool & downstream)
+{
+    pool = downstream;
+    for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++)
+	used[vc] = 0;
+    credit_seq = 0;
+}
+
+void LinkSender::update(const TBufferFullStatus & bfs)
+{
+    // the receiver returns at most one credit per cycle
+    if (bfs.credit_seq != credit_seq)
+    {
+	credit_seq = bfs.credit_seq;
+	used[bfs.credit_vc]--;
+	pool.release(used[bfs.credit_vc]);
+    }
+}
+
+bool LinkSender::hasCredit(const int vc) const
+{
+    return pool.canAccept(used[vc]);
+}
+
+void LinkSender::consumeCredit(const int vc)
+{
+    pool.acquire(used[vc]);
+    used[vc]++;
+}
@@ -0,0 +1,87 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the credit based flow control
+ */
+
+#ifndef __NOXIMFLOWCONTROL_H__
+#define __NOXIMFLOWCONTROL_H__
+
+#include <queue>
+#include "DataStructs.h"
+#include "Buffer.h"
+#include "Utils.h"
+
+using namespace std;
+
+// Number of pipeline stages of a link of the given length, when not
+// explicitly configured
+int linkStages(int configured_stages, double length_mm);
+
+// Receiving end of a credit based link: the sampled flits cross the
+// link pipeline before reaching the input buffer, and each freed slot
+// is returned to the sender through a pipeline of the same depth
+class LinkReceiver {
+
+  public:
+
+    LinkReceiver();
+
+    void setStages(const int stages);
+
+    void reset();
+
+    // Flit sampled from the link in the current cycle
+    void receive(const Flit & flit);
+
+    // True when the oldest flit in flight reached the input buffer
+    bool flitArrived() const;
+
+    Flit popFlit();
+
+    // A slot of vc has been freed
+    void returnCredit(const int vc);
+
+    // Writes in bfs the credit leaving the pipeline in the current
+    // cycle, at most one per cycle
+    void writeCredit(TBufferFullStatus & bfs);
+
+  private:
+
+    int stages;
+    queue<pair<double, Flit> > flits;   // <arrival cycle, flit>
+    queue<pair<double, int> > credits;  // <return cycle, vc>
+    int credit_seq;
+    int credit_vc;
+};
+
+// Sending end of a credit based link
+class LinkSender {
+
+  public:
+
+    LinkSender();
+
+    // credits start from the slots of the downstream input port
+    void reset(const BufferPool & downstream);
+
+    // Collects the credit returned by the receiver, if any
+    void update(const TBufferFullStatus & bfs);
+
+    bool hasCredit(const int vc) const;
+
+    void consumeCredit(const int vc);
+
+  private:
+
+    // mirror of the downstream port: flits stored or in flight per VC
+    BufferPool pool;
+    int used[MAX_VIRTUAL_CHANNELS];
+    int credit_seq;
+};
+
+#endif
@@ -23,18 +23,57 @@ int GlobalParams::n_delta_tiles;
 
 double GlobalParams::r2r_link_length;
 double GlobalParams::r2h_link_length;
+string GlobalParams::flow_control;
+int GlobalParams::r2r_link_stages;
+int GlobalParams::r2h_link_stages;
+double GlobalParams::link_mm_per_cycle;
 int GlobalParams::buffer_depth;
+string GlobalParams::buffer_organization;
+string GlobalParams::router_architecture;
+bool GlobalParams::router_power_gating;
+int GlobalParams::rpg_idle_threshold;
+int GlobalParams::rpg_wakeup_latency;
+int GlobalParams::rpg_breakeven_cycles;
+int GlobalParams::damq_min_slots;
 int GlobalParams::flit_size;
 int GlobalParams::min_packet_size;
 int GlobalParams::max_packet_size;
 string GlobalParams::routing_algorithm;
 string GlobalParams::routing_table_filename;
+string GlobalParams::escape_routing;
 string GlobalParams::selection_strategy;
+double GlobalParams::rca_weight;
+string GlobalParams::allocator;
+int GlobalParams::islip_iterations;
+bool GlobalParams::lookahead_routing;
+int GlobalParams::qos_classes;
+bool GlobalParams::router_bypass;
 double GlobalParams::packet_injection_rate;
 double GlobalParams::probability_of_retransmission;
+string GlobalParams::injection_process;
+vector <double> GlobalParams::mmpp_state_rates;
+vector <double> GlobalParams::mmpp_state_sojourn;
+double GlobalParams::hurst;
+int GlobalParams::onoff_sources;
+double GlobalParams::onoff_mean_period;
+int GlobalParams::dma_burst;
+int GlobalParams::source_queue_size;
+TrafficProfile GlobalParams::default_traffic_profile;
+vector <TrafficProfile> GlobalParams::traffic_profiles;
+vector <TrafficProfile> GlobalParams::node_traffic_profile;
+string GlobalParams::source_queue_policy;
 double GlobalParams::locality;
+double GlobalParams::multicast_rate;
+int GlobalParams::multicast_size;
 string GlobalParams::traffic_distribution;
 string GlobalParams::traffic_table_filename;
+vector <TrafficPattern> GlobalParams::traffic_table_patterns;
+string GlobalParams::trace_replay_filename;
+string GlobalParams::task_graph_filename;
+vector <int> GlobalParams::memory_controllers;
+int GlobalParams::max_outstanding;
+int GlobalParams::reply_size;
+int GlobalParams::service_latency;
 string GlobalParams::config_filename;
 string GlobalParams::power_config_filename;
 int GlobalParams::clock_period_ps;
@@ -50,7 +89,17 @@ vector <pair <int, double> > GlobalParams::hotspots;
 bool GlobalParams::show_buffer_stats;
 bool GlobalParams::use_winoc;
 int GlobalParams::winoc_dst_hops;
+string GlobalParams::winoc_routing_policy;
 bool GlobalParams::use_powermanager;
+bool GlobalParams::use_predictive_powermanager;
+int GlobalParams::wirxsleep_wakeup_latency;
+double GlobalParams::wirxsleep_confidence;
+int GlobalParams::wireless_retry_limit;
+int GlobalParams::wireless_retry_timeout;
+double GlobalParams::wireless_sinr_threshold;
+double GlobalParams::wireless_noise_floor;
+double GlobalParams::wireless_path_loss_exponent;
+double GlobalParams::wireless_path_loss_1mm;
 ChannelConfig GlobalParams::default_channel_configuration;
 map<int, ChannelConfig> GlobalParams::channel_configuration;
 HubConfig GlobalParams::default_hub_configuration;
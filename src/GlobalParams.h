@@ -17,6 +17,8 @@
 #include <vector>
 #include <string>
 
+#include "TrafficTableGenerator.h"
+
 using namespace std;
 
 #define CONFIG_FILENAME        "config.yaml"
@@ -34,6 +36,10 @@ using namespace std;
 #define DIRECTION_WIRELESS    747
 
 #define MAX_VIRTUAL_CHANNELS	8
+
+// Largest network where multicast destination sets can be used
+#define MAX_MULTICAST_NODES	256
+
 #define DEFAULT_VC 		0
 
 #define RT_AVAILABLE 1
@@ -55,8 +61,10 @@ using namespace std;
 #define TOPOLOGY_OMEGA         "OMEGA"
 
 // Routing algorithms
+#define ROUTING_XY             "XY"
 #define ROUTING_DYAD           "DYAD"
 #define ROUTING_TABLE_BASED    "TABLE_BASED"
+#define ROUTING_FULLY_ADAPTIVE "FULLY_ADAPTIVE"
 
 
 // Channel selection 
@@ -74,6 +82,19 @@ using namespace std;
 #define TRAFFIC_BUTTERFLY      "TRAFFIC_BUTTERFLY"
 #define TRAFFIC_LOCAL	       "TRAFFIC_LOCAL"
 #define TRAFFIC_ULOCAL	       "TRAFFIC_ULOCAL"
+#define TRAFFIC_TRACE_REPLAY   "TRAFFIC_TRACE_REPLAY"
+#define TRAFFIC_CLOSED_LOOP    "TRAFFIC_CLOSED_LOOP"
+#define TRAFFIC_TASK_GRAPH     "TRAFFIC_TASK_GRAPH"
+
+// Injection processes (time distribution of the synthetic traffic)
+#define INJECTION_BERNOULLI    "BERNOULLI"
+#define INJECTION_MMPP         "MMPP"
+#define INJECTION_SELF_SIMILAR "SELF_SIMILAR"
+#define INJECTION_DMA          "DMA"
+
+// Policies of a full source queue
+#define SOURCE_QUEUE_STALL     "STALL"
+#define SOURCE_QUEUE_DROP      "DROP"
 
 // Verbosity levels
 #define VERBOSE_OFF            "VERBOSE_OFF"
@@ -82,6 +103,18 @@ using namespace std;
 #define VERBOSE_HIGH           "VERBOSE_HIGH"
 
 
+// Flow control
+#define FLOW_CONTROL_ABP    "ABP"
+#define FLOW_CONTROL_CREDIT "CREDIT"
+
+// Organization of the router input buffers
+#define BUFFER_STATIC "STATIC"
+#define BUFFER_DAMQ   "DAMQ"
+
+// Router micro-architectures
+#define ROUTER_BUFFERED  "BUFFERED"
+#define ROUTER_DEFLECTION "DEFLECTION"
+
 // Wireless MAC constants
 #define RELEASE_CHANNEL 1
 #define HOLD_CHANNEL 	2
@@ -89,6 +122,11 @@ using namespace std;
 #define TOKEN_HOLD             "TOKEN_HOLD"
 #define TOKEN_MAX_HOLD         "TOKEN_MAX_HOLD"
 #define TOKEN_PACKET           "TOKEN_PACKET"
+#define SPATIAL_REUSE          "SPATIAL_REUSE"
+
+// Wireless vs wired path selection policies
+#define WINOC_ROUTING_STATIC   "STATIC"
+#define WINOC_ROUTING_ADAPTIVE "ADAPTIVE"
 
 typedef struct {
     pair<double, double> ber;
@@ -104,8 +142,27 @@ typedef struct {
     int fromTileBufferSize;
     int txBufferSize;
     int rxBufferSize;
+    vector<double> position; // [x, y] in mm
+    double txPower;          // dBm
 } HubConfig;
 
+// Traffic generated by the PEs with a synthetic traffic distribution.
+// The default profile holds the global parameters, the ones of the
+// TrafficProfiles section override them for some nodes
+typedef struct {
+    string name;
+    vector<int> nodes;		// nodes the profile applies to
+    vector<int> region;		// [x0, y0, x1, y1] mesh rectangle the profile applies to
+    double packet_injection_rate;
+    double probability_of_retransmission;
+    string injection_process;
+    string traffic_distribution;
+    int min_packet_size;
+    int max_packet_size;
+    vector<int> packet_sizes;	// when not empty, sizes drawn with packet_size_weights instead of min..max
+    vector<double> packet_size_weights;
+} TrafficProfile;
+
 typedef struct {
     map<pair <int, int>, double> front;
     map<pair <int, int>, double> pop;
@@ -148,18 +205,57 @@ struct GlobalParams {
     static int n_delta_tiles;
     static double r2r_link_length;
     static double r2h_link_length;
+    static string flow_control;
+    static int r2r_link_stages;
+    static int r2h_link_stages;
+    static double link_mm_per_cycle;
     static int buffer_depth;
+    static string buffer_organization;
+    static string router_architecture;
+    static bool router_power_gating;
+    static int rpg_idle_threshold;
+    static int rpg_wakeup_latency;
+    static int rpg_breakeven_cycles;
+    static int damq_min_slots;
     static int flit_size;
     static int min_packet_size;
     static int max_packet_size;
     static string routing_algorithm;
     static string routing_table_filename;
+    static string escape_routing;
     static string selection_strategy;
+    static double rca_weight;
+    static string allocator;
+    static int islip_iterations;
+    static bool lookahead_routing;
+    static int qos_classes;
+    static bool router_bypass;
     static double packet_injection_rate;
     static double probability_of_retransmission;
+    static string injection_process;
+    static vector <double> mmpp_state_rates;
+    static vector <double> mmpp_state_sojourn;
+    static double hurst;
+    static int onoff_sources;
+    static double onoff_mean_period;
+    static int dma_burst;
+    static int source_queue_size;
+    static TrafficProfile default_traffic_profile;
+    static vector <TrafficProfile> traffic_profiles;
+    static vector <TrafficProfile> node_traffic_profile;
+    static string source_queue_policy;
     static double locality;
+    static double multicast_rate;
+    static int multicast_size;
     static string traffic_distribution;
     static string traffic_table_filename;
+    static vector <TrafficPattern> traffic_table_patterns;
+    static string trace_replay_filename;
+    static string task_graph_filename;
+    static vector <int> memory_controllers;
+    static int max_outstanding;
+    static int reply_size;
+    static int service_latency;
     static string config_filename;
     static string power_config_filename;
     static int clock_period_ps;
@@ -175,7 +271,17 @@ struct GlobalParams {
     static bool show_buffer_stats;
     static bool use_winoc;
     static int winoc_dst_hops;
+    static string winoc_routing_policy;
     static bool use_powermanager;
+    static bool use_predictive_powermanager;
+    static int wirxsleep_wakeup_latency;
+    static double wirxsleep_confidence;
+    static int wireless_retry_limit;
+    static int wireless_retry_timeout;
+    static double wireless_sinr_threshold;
+    static double wireless_noise_floor;
+    static double wireless_path_loss_exponent;
+    static double wireless_path_loss_1mm;
     static ChannelConfig default_channel_configuration;
     static map<int, ChannelConfig> channel_configuration;
     static HubConfig default_hub_configuration;
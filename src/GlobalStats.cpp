@@ -68,6 +68,63 @@ double GlobalStats::getAverageDelay()
 
 
 
+double GlobalStats::getAverageSourceDelay()
+{
+    unsigned int total_packets = 0;
+    double avg_delay = 0.0;
+    vector < Tile * > tiles;
+
+    if (GlobalParams::topology == TOPOLOGY_MESH)
+    {
+	for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	    for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		tiles.push_back(noc->t[x][y]);
+    }
+    else // other delta topologies
+    {
+	for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    tiles.push_back(noc->core[y]);
+    }
+
+    for (unsigned int i = 0; i < tiles.size(); i++)
+    {
+	unsigned int received_packets = tiles[i]->r->stats.getReceivedPackets();
+
+	avg_delay += received_packets * tiles[i]->r->stats.getAverageSourceDelay();
+	total_packets += received_packets;
+    }
+
+    avg_delay /= (double) total_packets;
+
+    return avg_delay;
+}
+
+unsigned long long GlobalStats::getTrafficSignature()
+{
+    vector < ProcessingElement * > pes;
+    unsigned long long signature = 14695981039346656037ULL;
+
+    if (GlobalParams::topology == TOPOLOGY_MESH)
+    {
+	for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	    for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		pes.push_back(noc->t[x][y]->pe);
+    }
+    else // other delta topologies
+    {
+	for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    pes.push_back(noc->core[y]->pe);
+    }
+
+    for (unsigned int i = 0; i < pes.size(); i++)
+    {
+	signature ^= pes[i]->traffic_signature;
+	signature *= 1099511628211ULL;
+    }
+
+    return signature;
+}
+
 double GlobalStats::getAverageDelay(const int src_id,
 					 const int dst_id)
 {
@@ -227,6 +284,37 @@ unsigned int GlobalStats::getReceivedPackets()
     return n;
 }
 
+unsigned long GlobalStats::getBypassedFlits()
+{
+    unsigned long n = 0;
+
+    if (GlobalParams::topology == TOPOLOGY_MESH) 
+    {
+	for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	    for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		n += noc->t[x][y]->r->getBypassedFlits();
+    }
+    else // other delta topologies
+    {
+	for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    n += noc->core[y]->r->getBypassedFlits();
+    }
+
+    return n;
+}
+
+unsigned long GlobalStats::getDeflections()
+{
+    unsigned long n = 0;
+
+    // DEFLECTION routers are only available on meshes
+    for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+	    n += noc->t[x][y]->r->stats.getDeflections();
+
+    return n;
+}
+
 unsigned int GlobalStats::getReceivedFlits()
 {
     unsigned int n = 0;
@@ -510,13 +598,61 @@ void GlobalStats::showStats(std::ostream & out, bool detailed)
     out << "% Total received flits: " << getReceivedFlits() << endl;
     out << "% Received/Ideal flits Ratio: " << getReceivedIdealFlitRatio() << endl;
     out << "% Average wireless utilization: " << getWirelessPackets()/(double)getReceivedPackets() << endl;
-    out << "% Global average delay (cycles): " << getAverageDelay() << endl;
+    double avg_delay = getAverageDelay();
+    double avg_source_delay = getAverageSourceDelay();
+    out << "% Global average delay (cycles): " << avg_delay << endl;
+    out << "% \tSource queue delay (cycles): " << avg_source_delay << endl;
+    out << "% \tNetwork delay (cycles): " << avg_delay - avg_source_delay << endl;
     out << "% Max delay (cycles): " << getMaxDelay() << endl;
     out << "% Network throughput (flits/cycle): " << getAggregatedThroughput() << endl;
     out << "% Average IP throughput (flits/cycle/IP): " << getThroughput() << endl;
     out << "% Total energy (J): " << getTotalPower() << endl;
     out << "% \tDynamic energy (J): " << getDynamicPower() << endl;
     out << "% \tStatic energy (J): " << getStaticPower() << endl;
+    out << "% Offered traffic signature: " << hex << getTrafficSignature() << dec << endl;
+
+    if (GlobalParams::qos_classes > 1)
+	showQoSStats(out);
+
+    if (GlobalParams::multicast_rate > 0)
+	showMulticastStats(out);
+
+    if (GlobalParams::traffic_distribution == TRAFFIC_CLOSED_LOOP)
+	showTransactionStats(out);
+
+    if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+    {
+	out << "% Completed tasks: " << noc->task_graph.getCompletedTasks() << " of " << noc->task_graph.size() << endl;
+	if (noc->task_graph.allCompleted())
+	    out << "% Application makespan (cycles): " << noc->task_graph.getMakespan() << endl;
+	else
+	    out << "% Application makespan (cycles): not completed" << endl;
+    }
+
+    if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+	out << "% Trace packets injected: " << noc->trace_replay.getInjected() << " of " << noc->trace_replay.getRecords() << endl;
+
+    if (GlobalParams::source_queue_size > 0)
+	showSourceQueueStats(out);
+
+    if (GlobalParams::router_power_gating)
+	showPowerGatingStats(out);
+
+    if (GlobalParams::router_bypass)
+	out << "% Flits bypassing the input buffers: " << getBypassedFlits() << endl;
+
+    if (GlobalParams::router_architecture == ROUTER_DEFLECTION)
+    {
+	unsigned long deflections = getDeflections();
+	out << "% Deflections: " << deflections << endl;
+	out << "% Average deflections per flit: " << deflections / (double)getReceivedFlits() << endl;
+    }
+
+    if (GlobalParams::use_winoc)
+    {
+	showWirelessRetransmissionStats(out);
+	showSpatialReuseStats(out);
+    }
 
     if (GlobalParams::show_buffer_stats)
       showBufferStats(out);
@@ -595,7 +731,7 @@ void GlobalStats::showPowerManagerStats(std::ostream & out)
 	for (map<int,int>::iterator i = h->buffer_to_tile_poweroff_cycles.begin();
 		i!=h->buffer_to_tile_poweroff_cycles.end();i++)
 	{
-	    double bttoff_fraction = i->second/(double)total_cycles;
+	    double bttoff_fraction = i->second/(double)GlobalParams::n_virtual_channels/total_cycles;
 	    s+=i->second;
 	    if (bttoff_fraction<0.25)
 		bttoff_str+=" ";
@@ -610,17 +746,306 @@ void GlobalStats::showPowerManagerStats(std::ostream & out)
 	    
 
 	}
-	out << (double)s/h->buffer_to_tile_poweroff_cycles.size()/total_cycles << "\t" << bttoff_str << endl;
+	out << (double)s/h->buffer_to_tile_poweroff_cycles.size()/GlobalParams::n_virtual_channels/total_cycles << "\t" << bttoff_str << endl;
     }
 
     out << "];" << endl;
 
+    if (GlobalParams::use_predictive_powermanager)
+    {
+	out << "powermanager_stats_predictive = [" << endl;
+	out << "%\tFraction of: RX Transceiver off in predicted idle windows (PTRXoff), wake-ups, wake-up latency (cycles), energy saved (J)" << endl;
+	out << "%\tHUB\tPTRXoff\tWakeups\tPenalty\tSaved" << endl;
+
+	int total_wakeups = 0;
+	int total_penalty = 0;
+	double total_saved = 0.0;
+
+	for (map<int, HubConfig>::iterator it = GlobalParams::hub_configuration.begin();
+		it != GlobalParams::hub_configuration.end();
+		++it)
+	{
+	    int hub_id = it->first;
+
+	    map<int,Hub*>::const_iterator i = noc->hub.find(hub_id);
+	    Hub * h = i->second;
+
+	    double saved = h->predictive_sleep_cycles * h->power.getRxIdleEnergy();
+
+	    out.precision(4);
+	    out << "\t" << hub_id << "\t" << std::fixed << (double)h->predictive_sleep_cycles/total_cycles << "\t";
+	    out << h->rx_wakeups << "\t" << h->rx_wakeup_penalty_cycles << "\t";
+	    out.unsetf(std::ios::fixed);
+	    out << saved << endl;
+
+	    total_wakeups += h->rx_wakeups;
+	    total_penalty += h->rx_wakeup_penalty_cycles;
+	    total_saved += saved;
+	}
+
+	out << "];" << endl;
+	out << "% Predictive sleep energy saved (J): " << total_saved << endl;
+	out << "% Receiver wake-ups: " << total_wakeups << endl;
+	out << "% Wake-up latency penalty (cycles): " << total_penalty << endl;
+    }
+
     out.unsetf(std::ios::fixed);
 
     out.precision(p);
 
 }
 
+void GlobalStats::showWirelessRetransmissionStats(std::ostream & out)
+{
+    int tx_flits = 0;
+    int retransmissions = 0;
+    int retransmission_cycles = 0;
+    int residual_errors = 0;
+    double retransmission_energy = 0.0;
+    int busy_cycles = 0;
+
+    for (map<int, HubConfig>::iterator it = GlobalParams::hub_configuration.begin();
+	    it != GlobalParams::hub_configuration.end();
+	    ++it)
+    {
+	int hub_id = it->first;
+
+	map<int,Hub*>::const_iterator i = noc->hub.find(hub_id);
+	Hub * h = i->second;
+
+	tx_flits += h->wireless_tx_flits;
+	retransmissions += h->wireless_retransmissions;
+	retransmission_cycles += h->wireless_retransmission_cycles;
+	residual_errors += h->wireless_residual_errors;
+	retransmission_energy += h->wireless_retransmission_energy;
+
+	// channel time used by the hub, ACK timeouts included
+	if (!h->txChannels.empty())
+	    busy_cycles += (h->wireless_tx_flits - h->wireless_retransmissions) * h->getFlitTransmissionCycles(h->txChannels[0]);
+    }
+    busy_cycles += retransmission_cycles;
+
+    out << "% Wireless flit transmissions: " << tx_flits << endl;
+    out << "% \tRetransmissions: " << retransmissions << endl;
+    out << "% \tResidual errors: " << residual_errors << endl;
+    out << "% Wireless retransmission latency (cycles): " << retransmission_cycles << endl;
+    out << "% Wireless retransmission energy (J): " << retransmission_energy << endl;
+    out << "% Wireless bandwidth lost to retransmissions: " << (busy_cycles ? (double)retransmission_cycles/busy_cycles : 0.0) << endl;
+}
+
+void GlobalStats::showQoSStats(std::ostream & out)
+{
+    out << "qos_stats = [" << endl;
+    out << "%\tCLASS\tPackets\tAvgDelay\tP99Delay\tMaxDelay" << endl;
+
+    for (int c = 0; c < GlobalParams::qos_classes; c++)
+    {
+	vector < double > delays;
+
+	if (GlobalParams::topology == TOPOLOGY_MESH)
+	{
+	    for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+		for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		{
+		    const vector < double > & d = noc->t[x][y]->r->stats.getClassDelays(c);
+		    delays.insert(delays.end(), d.begin(), d.end());
+		}
+	}
+	else // other delta topologies
+	{
+	    for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    {
+		const vector < double > & d = noc->core[y]->r->stats.getClassDelays(c);
+		delays.insert(delays.end(), d.begin(), d.end());
+	    }
+	}
+
+	out << "\t" << c << "\t" << delays.size();
+
+	if (delays.empty())
+	{
+	    out << "\t-\t-\t-" << endl;
+	    continue;
+	}
+
+	sort(delays.begin(), delays.end());
+
+	double sum = 0.0;
+	for (unsigned int k = 0; k < delays.size(); k++)
+	    sum += delays[k];
+
+	out << "\t" << sum / delays.size()
+	    << "\t" << delays[(delays.size() - 1) * 99 / 100]
+	    << "\t" << delays.back() << endl;
+    }
+
+    out << "];" << endl;
+}
+
+void GlobalStats::showMulticastStats(std::ostream & out)
+{
+    // completion delay of each packet: its last delivery
+    map < pair < int, double >, double > completion;
+    unsigned long deliveries = 0;
+    double delivery_sum = 0.0;
+
+    // multicast packets are only available on meshes
+    for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+	{
+	    const map < pair < int, double >, double > & d = noc->t[x][y]->r->stats.getMulticastDelays();
+
+	    for (map < pair < int, double >, double >::const_iterator it = d.begin(); it != d.end(); ++it)
+	    {
+		deliveries++;
+		delivery_sum += it->second;
+		if (completion[it->first] < it->second)
+		    completion[it->first] = it->second;
+	    }
+	}
+
+    double completion_sum = 0.0;
+    for (map < pair < int, double >, double >::iterator it = completion.begin(); it != completion.end(); ++it)
+	completion_sum += it->second;
+
+    out << "% Multicast packets: " << completion.size() << endl;
+    out << "% Multicast deliveries: " << deliveries << endl;
+    if (deliveries > 0)
+    {
+	out << "% Average multicast delivery delay (cycles): " << delivery_sum / deliveries << endl;
+	out << "% Average multicast completion delay (cycles): " << completion_sum / completion.size() << endl;
+    }
+}
+
+void GlobalStats::showSourceQueueStats(std::ostream & out)
+{
+    vector < ProcessingElement * > pes;
+
+    if (GlobalParams::topology == TOPOLOGY_MESH)
+    {
+	for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	    for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		pes.push_back(noc->t[x][y]->pe);
+    }
+    else // other delta topologies
+    {
+	for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    pes.push_back(noc->core[y]->pe);
+    }
+
+    double cycles = sc_time_stamp().to_double() / GlobalParams::clock_period_ps
+	- GlobalParams::reset_time - GlobalParams::stats_warm_up_time;
+    unsigned long offered = 0, accepted = 0, dropped = 0;
+
+    out << "source_queue_stats = [" << endl;
+    out << "%\tOffered and accepted load (flits/cycle), dropped packets, fraction of cycles stalled, max occupancy (packets)" << endl;
+    out << "%\tPE\tOffered\tAccepted\tDropped\tStalled\tMax" << endl;
+
+    for (unsigned int i = 0; i < pes.size(); i++)
+    {
+	ProcessingElement * pe = pes[i];
+
+	out << "\t" << pe->local_id << "\t" << pe->offered_flits / cycles << "\t" << pe->accepted_flits / cycles
+	    << "\t" << pe->dropped_packets << "\t" << pe->stalled_cycles / cycles << "\t" << pe->max_queue_size << endl;
+
+	offered += pe->offered_flits;
+	accepted += pe->accepted_flits;
+	dropped += pe->dropped_packets;
+    }
+
+    out << "];" << endl;
+    out << "% Offered load (flits/cycle/IP): " << offered / cycles / pes.size() << endl;
+    out << "% Accepted load (flits/cycle/IP): " << accepted / cycles / pes.size() << endl;
+    out << "% Dropped packets: " << dropped << endl;
+}
+
+void GlobalStats::showPowerGatingStats(std::ostream & out)
+{
+    int total_cycles = sc_time_stamp().to_double() / GlobalParams::clock_period_ps - GlobalParams::reset_time;
+    double total_saved = 0.0;
+
+    out << "power_gating_stats = [" << endl;
+    out << "%\tFraction of cycles gated (Gated), gating events, leakage saved net of the overheads (Saved)" << endl;
+    out << "%\tROUTER\tGated\tEvents\tSaved(J)" << endl;
+
+    // power gating is only available on meshes
+    for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+	{
+	    Router * r = noc->t[x][y]->r;
+
+	    out << "\t" << r->local_id << "\t" << (double)r->gated_cycles / total_cycles
+		<< "\t" << r->gating_events << "\t" << r->gating_saved_energy << endl;
+	    total_saved += r->gating_saved_energy;
+	}
+
+    out << "];" << endl;
+    out << "% Router power gating saved energy (J): " << total_saved << endl;
+}
+
+void GlobalStats::showTransactionStats(std::ostream & out)
+{
+    vector < ProcessingElement * > pes;
+
+    if (GlobalParams::topology == TOPOLOGY_MESH)
+    {
+	for (int y = 0; y < GlobalParams::mesh_dim_y; y++)
+	    for (int x = 0; x < GlobalParams::mesh_dim_x; x++)
+		pes.push_back(noc->t[x][y]->pe);
+    }
+    else // other delta topologies
+    {
+	for (int y = 0; y < GlobalParams::n_delta_tiles; y++)
+	    pes.push_back(noc->core[y]->pe);
+    }
+
+    unsigned long transactions = 0;
+    int requesters = 0;
+    double round_trip_sum = 0.0;
+    double round_trip_max = 0.0;
+
+    for (unsigned int i = 0; i < pes.size(); i++)
+    {
+	if (pes[i]->memory_controller)
+	    continue;
+
+	requesters++;
+	transactions += pes[i]->transactions;
+	round_trip_sum += pes[i]->round_trip_sum;
+	round_trip_max = max(round_trip_max, pes[i]->round_trip_max);
+    }
+
+    double cycles = sc_time_stamp().to_double() / GlobalParams::clock_period_ps
+	- GlobalParams::reset_time - GlobalParams::stats_warm_up_time;
+
+    out << "% Completed transactions: " << transactions << endl;
+    if (transactions > 0)
+    {
+	out << "% Average round-trip latency (cycles): " << round_trip_sum / transactions << endl;
+	out << "% Max round-trip latency (cycles): " << round_trip_max << endl;
+    }
+    out << "% Transaction throughput (transactions/cycle): " << transactions / cycles << endl;
+    out << "% Average requester throughput (transactions/cycle/requester): " << transactions / cycles / requesters << endl;
+}
+
+void GlobalStats::showSpatialReuseStats(std::ostream & out)
+{
+    for (map<int, ChannelConfig>::iterator it = GlobalParams::channel_configuration.begin();
+	    it != GlobalParams::channel_configuration.end();
+	    ++it)
+    {
+	if (it->second.macPolicy[0] != SPATIAL_REUSE)
+	    continue;
+
+	map<int,Channel*>::const_iterator i = noc->channel.find(it->first);
+	Channel * c = i->second;
+
+	out << "% Channel " << it->first << " average concurrent transmissions: " << (c->busy_cycles > 0 ? c->concurrency_cycles/c->busy_cycles : 0.0) << endl;
+	out << "% \tGranted transmissions: " << c->granted_transmissions << endl;
+	out << "% \tRequests deferred by interference: " << c->deferred_requests << endl;
+    }
+}
+
 void GlobalStats::showPowerBreakDown(std::ostream & out)
 {
     map<string,double> power_dynamic;
@@ -698,16 +1123,26 @@ double GlobalStats::getReceivedIdealFlitRatio()
 {
     int total_cycles;
     total_cycles= GlobalParams::simulation_time - GlobalParams::stats_warm_up_time;
-    double ratio;
-    if (GlobalParams::topology == TOPOLOGY_MESH) 
-    {
-	ratio = getReceivedFlits() /(GlobalParams::packet_injection_rate * (GlobalParams::min_packet_size +
-		    GlobalParams::max_packet_size)/2 * total_cycles * GlobalParams::mesh_dim_y * GlobalParams::mesh_dim_x);
-    }
-    else // other delta topologies
+
+    // flits/cycle offered by all the nodes, each one with its profile
+    double ideal_rate = 0.0;
+    for (unsigned int i = 0; i < GlobalParams::node_traffic_profile.size(); i++)
     {
-	ratio = getReceivedFlits() /(GlobalParams::packet_injection_rate * (GlobalParams::min_packet_size +
-		    GlobalParams::max_packet_size)/2 * total_cycles * GlobalParams::n_delta_tiles);
+	const TrafficProfile & profile = GlobalParams::node_traffic_profile[i];
+	double avg_size = (profile.min_packet_size + profile.max_packet_size) / 2.0;
+
+	if (!profile.packet_sizes.empty())
+	{
+	    double total = 0.0, weighted = 0.0;
+	    for (unsigned int s = 0; s < profile.packet_sizes.size(); s++)
+	    {
+		weighted += profile.packet_sizes[s] * profile.packet_size_weights[s];
+		total += profile.packet_size_weights[s];
+	    }
+	    avg_size = weighted / total;
+	}
+	ideal_rate += profile.packet_injection_rate * avg_size;
     }
-    return ratio;
+
+    return getReceivedFlits() / (ideal_rate * total_cycles);
 }
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 #include "NoC.h"
 #include "Tile.h"
 using namespace std;
@@ -30,6 +31,14 @@ class GlobalStats {
     // Returns the aggragated average delay (cycles) for communication src_id->dst_id
     double getAverageDelay(const int src_id, const int dst_id);
 
+    // Returns the average time (cycles) spent by the received packets
+    // in the source queues
+    double getAverageSourceDelay();
+
+    // Hash of the packets offered by all the PEs: equal signatures mean
+    // that two runs were offered the same traffic
+    unsigned long long getTrafficSignature();
+
     // Returns the max delay
     double getMaxDelay();
 
@@ -63,6 +72,12 @@ class GlobalStats {
     // Returns the total number of received flits
     unsigned int getReceivedFlits();
 
+    // Returns the number of router traversals which skipped the input buffers
+    unsigned long getBypassedFlits();
+
+    // Returns the deflections suffered by all the received flits
+    unsigned long getDeflections();
+
     // number of packets that used the wireless network
     unsigned int getWirelessPackets();
 
@@ -88,6 +103,26 @@ class GlobalStats {
 
     void showPowerManagerStats(std::ostream & out);
 
+    void showWirelessRetransmissionStats(std::ostream & out);
+
+    void showSpatialReuseStats(std::ostream & out);
+
+    // latency per QoS class (average, 99th percentile, max)
+    void showQoSStats(std::ostream & out);
+
+    // multicast latency: average over the single deliveries, and up to
+    // the last destination of each packet
+    void showMulticastStats(std::ostream & out);
+
+    // closed-loop traffic: round-trip latency and transaction throughput
+    void showTransactionStats(std::ostream & out);
+
+    // bounded source queues: offered and accepted load, drops and stalls
+    void showSourceQueueStats(std::ostream & out);
+
+    // per router gated cycles, gating events and leakage energy saved
+    void showPowerGatingStats(std::ostream & out);
+
     double getReceivedIdealFlitRatio();
 
 
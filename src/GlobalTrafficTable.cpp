@@ -10,20 +10,43 @@
 
 #include "GlobalTrafficTable.h"
 
+#include <algorithm>
+#include <cstring>
+
 GlobalTrafficTable::GlobalTrafficTable()
 {
 }
 
+static bool sourceLess(const Communication & a, const Communication & b)
+{
+  return a.src < b.src;
+}
+
 bool GlobalTrafficTable::load(const char *fname)
 {
+  // Initialize variables
+  traffic_table.clear();
+
+  // Binary tables are read as a whole
+  FILE *fbin = fopen(fname, "rb");
+  if (fbin == NULL)
+    return false;
+
+  char magic[4];
+  if (fread(magic, sizeof(magic), 1, fbin) == 1 &&
+      memcmp(magic, TRAFFIC_TABLE_MAGIC, sizeof(magic)) == 0) {
+    rewind(fbin);
+    bool ok = loadBinary(fbin);
+    fclose(fbin);
+    return ok;
+  }
+  fclose(fbin);
+
   // Open file
   ifstream fin(fname, ios::in);
   if (!fin)
     return false;
 
-  // Initialize variables
-  traffic_table.clear();
-
   // Cycle reading file
   while (!fin.eof()) {
     char line[512];
@@ -34,10 +57,11 @@ bool GlobalTrafficTable::load(const char *fname)
 	int src, dst;	// Mandatory
 	double pir, por;
 	int t_on, t_off, t_period;
+	int traffic_class;
 
 	int params =
-	  sscanf(line, "%d %d %lf %lf %d %d %d", &src, &dst, &pir,
-		 &por, &t_on, &t_off, &t_period);
+	  sscanf(line, "%d %d %lf %lf %d %d %d %d", &src, &dst, &pir,
+		 &por, &t_on, &t_off, &t_period, &traffic_class);
 	if (params >= 2) {
 	  // Create a communication from the parameters read on the line
 	  Communication communication;
@@ -83,6 +107,13 @@ bool GlobalTrafficTable::load(const char *fname)
 	      GlobalParams::reset_time +
 	      GlobalParams::simulation_time;
 
+	  // Custom QoS class
+	  if (params >= 8) {
+	    assert(traffic_class >= 0 && traffic_class < GlobalParams::qos_classes);
+	    communication.traffic_class = traffic_class;
+	  } else
+	    communication.traffic_class = 0;
+
 	  // Add this communication to the vector of communications
 	  traffic_table.push_back(communication);
 	}
@@ -90,9 +121,113 @@ bool GlobalTrafficTable::load(const char *fname)
     }
   }
 
+  buildIndex();
+
   return true;
 }
 
+bool GlobalTrafficTable::loadBinary(FILE *fin)
+{
+  TrafficTableHeader header;
+
+  if (fread(&header, sizeof(header), 1, fin) != 1 ||
+      header.version != TRAFFIC_TABLE_VERSION) {
+    cerr << "Error: unsupported binary traffic table" << endl;
+    return false;
+  }
+
+  // the number of records must fit in the file before allocating them
+  long records_start = ftell(fin);
+  if (fseek(fin, 0, SEEK_END) != 0 || ftell(fin) < records_start ||
+      header.n_communications > (uint64_t) (ftell(fin) - records_start) / sizeof(Communication)) {
+    cerr << "Error: truncated binary traffic table" << endl;
+    return false;
+  }
+  fseek(fin, records_start, SEEK_SET);
+
+  traffic_table.resize(header.n_communications);
+  if (header.n_communications > 0 &&
+      fread(&traffic_table[0], sizeof(Communication), header.n_communications, fin) != header.n_communications) {
+    cerr << "Error: truncated binary traffic table" << endl;
+    return false;
+  }
+
+  int n_nodes = (GlobalParams::topology == TOPOLOGY_MESH) ?
+    GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y : GlobalParams::n_delta_tiles;
+
+  // same constraints as the text rows
+  for (unsigned int i = 0; i < traffic_table.size(); i++) {
+    Communication & c = traffic_table[i];
+    bool period_forever = (c.t_period == TRAFFIC_TABLE_FOREVER);
+
+    complete(c);
+
+    if (c.src < 0 || c.src >= n_nodes || c.dst < 0 || c.dst >= n_nodes ||
+	!(c.pir >= 0 && c.pir <= 1) || !(c.por >= 0 && c.por <= 1) ||
+	c.t_on < 0 || c.t_off <= c.t_on || c.t_period <= 0 || (!period_forever && c.t_period <= c.t_off) ||
+	c.traffic_class < 0 || c.traffic_class >= GlobalParams::qos_classes) {
+      cerr << "Error: invalid communication " << i << " in the binary traffic table" << endl;
+      return false;
+    }
+  }
+
+  buildIndex();
+
+  return true;
+}
+
+bool GlobalTrafficTable::generate(const vector < TrafficPattern > & patterns)
+{
+  if (GlobalParams::topology != TOPOLOGY_MESH) {
+    cerr << "Error: traffic patterns are only available on mesh topologies" << endl;
+    return false;
+  }
+
+  // the random patterns only depend on the seed
+  srand(GlobalParams::rnd_generator_seed);
+
+  TrafficTableGenerator generator(GlobalParams::mesh_dim_x, GlobalParams::mesh_dim_y);
+  for (unsigned int i = 0; i < patterns.size(); i++)
+    if (!generator.add(patterns[i]))
+      return false;
+
+  traffic_table = generator.getTable();
+  for (unsigned int i = 0; i < traffic_table.size(); i++)
+    complete(traffic_table[i]);
+
+  buildIndex();
+
+  return true;
+}
+
+void GlobalTrafficTable::complete(Communication & communication)
+{
+  if (communication.t_off == TRAFFIC_TABLE_FOREVER)
+    communication.t_off = GlobalParams::reset_time + GlobalParams::simulation_time;
+
+  if (communication.t_period == TRAFFIC_TABLE_FOREVER)
+    communication.t_period = GlobalParams::reset_time + GlobalParams::simulation_time;
+}
+
+void GlobalTrafficTable::buildIndex()
+{
+  // the order of the communications of a source is kept, as it
+  // decides the destination drawn
+  stable_sort(traffic_table.begin(), traffic_table.end(), sourceLess);
+
+  int n_sources = traffic_table.empty() ? 0 : max(0, traffic_table.back().src + 1);
+  source_first.assign(n_sources + 1, traffic_table.size());
+
+  for (int i = traffic_table.size() - 1; i >= 0; i--)
+    if (traffic_table[i].src >= 0)
+      source_first[traffic_table[i].src] = i;
+
+  // sources without communications start where the next one does
+  for (int s = n_sources - 1; s >= 0; s--)
+    if (source_first[s] > source_first[s + 1])
+      source_first[s] = source_first[s + 1];
+}
+
 double GlobalTrafficTable::getCumulativePirPor(const int src_id,
 						    const int ccycle,
 						    const bool pir_not_por,
@@ -102,28 +237,38 @@ double GlobalTrafficTable::getCumulativePirPor(const int src_id,
 
   dst_prob.clear();
 
-  for (unsigned int i = 0; i < traffic_table.size(); i++) {
-    Communication comm = traffic_table[i];
-    if (comm.src == src_id) {
-      int r_ccycle = ccycle % comm.t_period;
-      if (r_ccycle > comm.t_on && r_ccycle < comm.t_off) {
-	cpirnpor += pir_not_por ? comm.pir : comm.por;
-	pair < int, double >dp(comm.dst, cpirnpor);
-	dst_prob.push_back(dp);
-      }
+  if (src_id < 0 || src_id + 1 >= (int)source_first.size())
+    return cpirnpor;
+
+  for (unsigned int i = source_first[src_id]; i < source_first[src_id + 1]; i++) {
+    const Communication & comm = traffic_table[i];
+    int r_ccycle = ccycle % comm.t_period;
+    if (r_ccycle > comm.t_on && r_ccycle < comm.t_off) {
+      cpirnpor += pir_not_por ? comm.pir : comm.por;
+      pair < int, double >dp(comm.dst, cpirnpor);
+      dst_prob.push_back(dp);
     }
   }
 
   return cpirnpor;
 }
 
-int GlobalTrafficTable::occurrencesAsSource(const int src_id)
+int GlobalTrafficTable::getTrafficClass(const int src_id, const int dst_id)
 {
-  int count = 0;
+  if (src_id < 0 || src_id + 1 >= (int)source_first.size())
+    return 0;
 
-  for (unsigned int i = 0; i < traffic_table.size(); i++)
-    if (traffic_table[i].src == src_id)
-      count++;
+  for (unsigned int i = source_first[src_id]; i < source_first[src_id + 1]; i++)
+    if (traffic_table[i].dst == dst_id)
+      return traffic_table[i].traffic_class;
+
+  return 0;
+}
+
+int GlobalTrafficTable::occurrencesAsSource(const int src_id)
+{
+  if (src_id < 0 || src_id + 1 >= (int)source_first.size())
+    return 0;
 
-  return count;
+  return source_first[src_id + 1] - source_first[src_id];
 }
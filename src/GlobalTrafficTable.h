@@ -15,29 +15,24 @@
 #include <stdlib.h>
 #include <vector>
 #include "DataStructs.h"
+#include "TrafficTableGenerator.h"
 
 using namespace std;
 
-// Structure used to store information into the table
-struct Communication {
-  int src;			// ID of the source node (PE)
-  int dst;			// ID of the destination node (PE)
-  double pir;			// Packet Injection Rate for the link
-  double por;			// Probability Of Retransmission for the link
-  int t_on;			// Time (in cycles) at which activity begins
-  int t_off;			// Time (in cycles) at which activity ends
-  int t_period;		        // Period after which activity starts again
-};
-
 class GlobalTrafficTable {
 
   public:
 
     GlobalTrafficTable();
 
-    // Load traffic table from file. Returns true if ok, false otherwise
+    // Load traffic table from file, either text or binary (see
+    // TrafficTableGenerator). Returns true if ok, false otherwise
     bool load(const char *fname);
 
+    // Builds the traffic table of the given patterns (mesh only).
+    // Returns true if ok, false otherwise
+    bool generate(const vector < TrafficPattern > & patterns);
+
     // Returns the cumulative pir por along with a vector of pairs. The
     // first component of the pair is the destination. The second
     // component is the cumulative shotting probability.
@@ -50,9 +45,21 @@ class GlobalTrafficTable {
     // table
     int occurrencesAsSource(const int src_id);
 
+    // Returns the QoS class of the communication src_id->dst_id
+    int getTrafficClass(const int src_id, const int dst_id);
+
   private:
 
-     vector < Communication > traffic_table;
+    bool loadBinary(FILE *fin);
+
+    // Default timing of the communications lasting the whole simulation
+    void complete(Communication & communication);
+
+    // Groups the communications by source
+    void buildIndex();
+
+     vector < Communication > traffic_table;	// sorted by source
+     vector < unsigned int > source_first;	// first communication of each source, plus the end
 };
 
 #endif
@@ -9,6 +9,7 @@
  * to forward configuration to every sub-block
  */
 #include "Hub.h"
+#include "Channel.h"
 
 int Hub::tile2Port(int id)
 {
@@ -39,24 +40,72 @@ int Hub::route(Flit& f)
 }
 
 
+int Hub::estimateWirelessCycles(int dst_hub, int packet_size)
+{
+	// flits already waiting to be moved towards the antenna compete
+	// for the same channel(s)
+	int queued_from_tile = 0;
+	for (int i = 0; i < num_ports; i++)
+		for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+			queued_from_tile += buffer_from_tile[i][vc].Size();
+
+	vector<int> & rx = GlobalParams::hub_configuration[dst_hub].rxChannels;
+
+	int best = NOT_VALID;
+
+	for (unsigned int i = 0; i < txChannels.size(); i++)
+	{
+		int channel = txChannels[i];
+
+		if (find(rx.begin(), rx.end(), channel) == rx.end())
+			continue;
+
+		int queued = queued_from_tile + init[channel]->buffer_tx.Size();
+		int cycles = token_ring->estimateTokenWait(channel, local_id) +
+			(int)ceil((queued + packet_size) * expectedFlitCycles(channel));
+
+		if (best == NOT_VALID || cycles < best)
+			best = cycles;
+	}
+
+	return best;
+}
+
+double Hub::expectedFlitCycles(int channel)
+{
+	// a flit is corrupted when at least one of its bits is wrong
+	pair<double, double> ber = GlobalParams::channel_configuration[channel].ber;
+	double p = 1.0 - pow(1.0 - (ber.first + ber.second) / 2.0, GlobalParams::flit_size);
+
+	// each NACKed transmission costs the flit time plus the ACK
+	// timeout, and at most wireless_retry_limit retransmissions are
+	// attempted (truncated geometric distribution)
+	double attempts = (1.0 - pow(p, GlobalParams::wireless_retry_limit + 1)) / (1.0 - p);
+	if (p >= 1.0)
+		attempts = GlobalParams::wireless_retry_limit + 1;
+
+	return attempts * flit_transmission_cycles[channel] +
+		(attempts - 1) * GlobalParams::wireless_retry_timeout;
+}
+
 void Hub::rxPowerManager()
 {
 	// Check wheter accounting or not buffer to tile leakage
-	// For each port, two poweroff condition should be checked:
+	// For each port and VC, two poweroff condition should be checked:
 	// - the buffer to tile is empty
 	// - it has not been reserved
 
-	// currently only supported without VC
-	assert(GlobalParams::n_virtual_channels==1);
-
 	for (int port=0;port<num_ports;port++)
 	{
-		if (!buffer_to_tile[port][DEFAULT_VC].IsEmpty() ||
-			antenna2tile_reservation_table.isNotReserved(port))
-			power.leakageBufferToTile();
+		for (int vc=0;vc<GlobalParams::n_virtual_channels;vc++)
+		{
+			if (!buffer_to_tile[port][vc].IsEmpty() ||
+				!antenna2tile_reservation_table.isNotReserved(port,vc))
+				power.leakageBufferToTile();
 
-		else
-			buffer_to_tile_poweroff_cycles[port]++;
+			else
+				buffer_to_tile_poweroff_cycles[port]++;
+		}
 	}
 
 
@@ -77,8 +126,14 @@ void Hub::rxPowerManager()
 	// To be only applied if the current hub is in RADIO_EVENT_SLEEP_ON mode
 
 	if (power.isSleeping())
+	{
 		total_sleep_cycles++;
 
+		int now = (int)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps);
+		if (now < predictive_sleep_end)
+			predictive_sleep_cycles++;
+	}
+
 	else // not sleeping
 	{
 		power.wirelessSnooping();
@@ -88,6 +143,74 @@ void Hub::rxPowerManager()
 }
 
 
+int Hub::predictIdleCycles() const
+{
+	if (idle_samples < IDLE_MIN_SAMPLES)
+		return 0;
+
+	// lower bound of the bin where the (1-confidence) quantile of the
+	// observed idle intervals falls, i.e. a fraction 'confidence' of
+	// the past idle windows lasted at least the returned value
+	int threshold = (int)((1.0 - GlobalParams::wirxsleep_confidence) * idle_samples);
+	int cumulative = 0;
+
+	for (int k = 0; k < IDLE_HISTOGRAM_BINS; k++)
+	{
+		cumulative += idle_histogram[k];
+		if (cumulative > threshold)
+			return 1 << k;
+	}
+
+	return 1 << (IDLE_HISTOGRAM_BINS - 1);
+}
+
+void Hub::notifyReception(const Flit & flit)
+{
+	if (!GlobalParams::use_predictive_powermanager) return;
+
+	int now = (int)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps);
+
+	// learn the length of the idle window just ended
+	if (flit.flit_type == FLIT_TYPE_HEAD && last_reception_cycle != NOT_VALID)
+	{
+		int idle = now - last_reception_cycle;
+		int k = 0;
+		while (idle > 1 && k < IDLE_HISTOGRAM_BINS - 1)
+		{
+			idle >>= 1;
+			k++;
+		}
+		idle_histogram[k]++;
+		idle_samples++;
+	}
+
+	if (flit.flit_type != FLIT_TYPE_TAIL)
+		return;
+
+	last_reception_cycle = now;
+
+	// sleep only if the predicted window pays off the wake-up latency
+	int predicted = predictIdleCycles();
+	int sleep_cycles = predicted - GlobalParams::wirxsleep_wakeup_latency;
+
+	if (sleep_cycles > GlobalParams::wirxsleep_wakeup_latency && !power.isSleeping())
+	{
+		LOG << "Predicted idle window of " << predicted << " cycles, sleeping for " << sleep_cycles << " cycles" << endl;
+		power.rxSleep(sleep_cycles);
+		predictive_sleep_end = now + sleep_cycles;
+	}
+}
+
+int Hub::rxWakeUp()
+{
+	power.rxWakeUp();
+	predictive_sleep_end = NOT_VALID;
+	rx_wakeups++;
+	rx_wakeup_penalty_cycles += GlobalParams::wirxsleep_wakeup_latency;
+
+	return GlobalParams::wirxsleep_wakeup_latency;
+}
+
 void Hub::updateRxPower()
 {
 	if (GlobalParams::use_powermanager)
@@ -112,15 +235,17 @@ void Hub::txPowerManager()
 {
 	for (unsigned int i=0;i<txChannels.size();i++)
 	{
-		// check if not empty or reserved
-		if (!init[i]->buffer_tx.IsEmpty() ||
-			tile2antenna_reservation_table.isNotReserved(i) )
+		int channel = txChannels[i];
+
+		// check if not empty or reserved by any port/VC
+		if (!init[channel]->buffer_tx.IsEmpty() ||
+			!tile2antenna_reservation_table.isNotReserved(channel) )
 		{
 			power.leakageAntennaBuffer();
 			// check the second condition for turning off analog tx
 			if (power.isSleeping())
 			{
-				analogtxoff_cycles[i]++;
+				analogtxoff_cycles[channel]++;
 			}
 			else
 			{
@@ -131,8 +256,8 @@ void Hub::txPowerManager()
 		else
 		{   // abtx is empty and not reserved - turn off
 			// note that this also applies to analog tx and serializer
-			abtxoff_cycles[i]++;
-			analogtxoff_cycles[i]++;
+			abtxoff_cycles[channel]++;
+			analogtxoff_cycles[channel]++;
 			total_ttxoff_cycles++;
 		}
 	}
@@ -248,6 +373,35 @@ void Hub::txRadioProcessTokenMaxHold(int channel)
 	}
 }
 
+void Hub::txRadioProcessSpatialReuse(int channel)
+{
+	if (init[channel]->buffer_tx.IsEmpty())
+		return;
+
+	Flit flit = init[channel]->buffer_tx.Front();
+
+	// the channel is requested once per packet and kept until the
+	// tail flit has been sent
+	if (!transmission_in_progress.at(channel))
+	{
+		int dst_hub;
+
+		if (flit.hub_relay_node!=NOT_VALID)
+			dst_hub = tile2Hub(flit.hub_relay_node);
+		else
+			dst_hub = tile2Hub(flit.dst_id);
+
+		if (!radio_channel[channel]->requestTransmission(local_id, dst_hub))
+		{
+			LOG << "*** [Ch"<<channel<<"] Transmission of " << flit << " deferred by interference" << endl;
+			return;
+		}
+	}
+
+	LOG << "*** [Ch"<<channel<<"] Requesting transmission event of flit " << flit << endl;
+	init[channel]->start_request_event.notify();
+}
+
 void Hub::antennaToTileProcess()
 {
 	if (reset.read())
@@ -256,9 +410,15 @@ void Hub::antennaToTileProcess()
 		{
 			req_tx[i]->write(0);
 			current_level_tx[i] = 0;
+			link_tx[i].reset(routerInputPool());
 		}
 		return;
 	}
+
+	if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+		for (int i = 0; i < num_ports; i++)
+			link_tx[i].update(buffer_full_status_tx[i].read());
+
 	// IMPORTANT: do not move from here
 	// The rxPowerManager must perform its checks before the flits are removed from buffers
 	updateRxPower();
@@ -291,8 +451,7 @@ void Hub::antennaToTileProcess()
 				Flit flit = buffer_to_tile[i][vc].Front();
 
 				LOG << "Flit " << flit << " found on buffer_to_tile[" << i <<"][" << vc << "] " << endl;
-				if (current_level_tx[i] == ack_tx[i].read() &&
-					buffer_full_status_tx[i].read().mask[vc] == false)
+				if (portReady(i, vc))
 				{
 					LOG << "Flit " << flit << " moved from buffer_to_tile[" << i <<"][" << vc << "] to signal flit_tx["<<i<<"] " << endl;
 
@@ -303,6 +462,9 @@ void Hub::antennaToTileProcess()
 					buffer_to_tile[i][vc].Pop();
 					power.bufferToTilePop();
 					power.r2hLink();
+
+					if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+						link_tx[i].consumeCredit(vc);
 					break; // port flit transmitted, skip remaining VCs
 				}
 				else
@@ -343,6 +505,7 @@ void Hub::antennaToTileProcess()
 				TReservation r;
 				r.input = channel;
 				r.vc = received_flit.vc_id;
+				r.out_vc = r.vc;
 
 				LOG << " Checking reservation availability of output port " << dst_port << " by channel " << channel << " for flit " << received_flit << endl;
 
@@ -372,56 +535,110 @@ void Hub::antennaToTileProcess()
 		}
 	}
 	// forwarding
-	for (unsigned int i = 0; i < rxChannels.size(); i++)
+	vector<AllocRequest> rx_grants = allocator->allocate(antenna2tile_allocator_state, antennaToTileRequests());
+
+	for (unsigned int g = 0; g < rx_grants.size(); g++)
 	{
-		int channel = rxChannels[i];
-		vector<pair<int,int> > reservations = antenna2tile_reservation_table.getReservations(channel);
+		int channel = rx_grants[g].input;
+		int port = rx_grants[g].output;
+		int vc = rx_grants[g].vc;
 
-		if (reservations.size()!=0)
+		if (!(target[channel]->buffer_rx.IsEmpty()))
 		{
-			int rnd_idx = rand()%reservations.size();
-
-			int port = reservations[rnd_idx].first;
-			int vc = reservations[rnd_idx].second;
+			Flit received_flit = target[channel]->buffer_rx.Front();
+			power.antennaBufferFront();
 
-			if (!(target[channel]->buffer_rx.IsEmpty()))
+			if ( !buffer_to_tile[port][vc].IsFull() )
 			{
-				Flit received_flit = target[channel]->buffer_rx.Front();
-				power.antennaBufferFront();
+				target[channel]->buffer_rx.Pop();
+				power.antennaBufferPop();
+				LOG << "*** [Ch" << channel << "] Moving flit  " << received_flit << " from buffer_rx to buffer_to_tile[" << port <<"][" << vc << "]" << endl;
 
-				if ( !buffer_to_tile[port][vc].IsFull() )
-				{
-					target[channel]->buffer_rx.Pop();
-					power.antennaBufferPop();
-					LOG << "*** [Ch" << channel << "] Moving flit  " << received_flit << " from buffer_rx to buffer_to_tile[" << port <<"][" << vc << "]" << endl;
-
-					buffer_to_tile[port][vc].Push(received_flit);
-					power.bufferToTilePush();
+				buffer_to_tile[port][vc].Push(received_flit);
+				power.bufferToTilePush();
 
-					if (received_flit.flit_type == FLIT_TYPE_TAIL)
-					{
-						LOG << "Releasing reservation for output port " << port << ", flit " << received_flit << endl;
-						TReservation r;
-						r.input = channel;
-						r.vc = vc;
-						antenna2tile_reservation_table.release(r,port);
-					}
+				if (received_flit.flit_type == FLIT_TYPE_TAIL)
+				{
+					LOG << "Releasing reservation for output port " << port << ", flit " << received_flit << endl;
+					TReservation r;
+					r.input = channel;
+					r.vc = vc;
+					antenna2tile_reservation_table.release(r,port);
 				}
-				else
-					LOG << "Full buffer_to_tile[" << port <<"][" << vc << "]" << ", cannot store " << received_flit << endl;
 			}
 			else
-			{
-				// should be ok
-				/*
+				LOG << "Full buffer_to_tile[" << port <<"][" << vc << "]" << ", cannot store " << received_flit << endl;
+		}
+		else
+		{
+			// should be ok
+			/*
                 LOG << "WARNING: empty target["<<channel<<"] buffer_rx, but reservation still present, if correct, remove assertion below " << endl;
                 assert(false);
                 */
-			}
 		}
 	}
 }
 
+vector<AllocRequest> Hub::antennaToTileRequests()
+{
+	vector<AllocRequest> requests;
+
+	for (int port = 0; port < num_ports; port++)
+	{
+		vector<TReservation> reservations = antenna2tile_reservation_table.getReservationsTo(port);
+
+		for (unsigned int k = 0; k < reservations.size(); k++)
+		{
+			AllocRequest request;
+			request.input = reservations[k].input;
+			request.vc = reservations[k].vc;
+			request.out_vc = reservations[k].out_vc;
+			request.output = port;
+			request.current = (k == 0);
+
+			// buffer_rx is a single queue, only its front flit can move
+			Buffer & buffer_rx = target[request.input]->buffer_rx;
+			request.ready = !buffer_rx.IsEmpty() &&
+				buffer_rx.Front().vc_id == request.vc &&
+				!buffer_to_tile[port][request.vc].IsFull();
+			if (!buffer_rx.IsEmpty())
+				request.setPriority(buffer_rx.Front());
+			requests.push_back(request);
+		}
+	}
+
+	return requests;
+}
+
+vector<AllocRequest> Hub::tileToAntennaRequests()
+{
+	vector<AllocRequest> requests;
+
+	for (unsigned int c = 0; c < txChannels.size(); c++)
+	{
+		int channel = txChannels[c];
+		vector<TReservation> reservations = tile2antenna_reservation_table.getReservationsTo(channel);
+
+		for (unsigned int k = 0; k < reservations.size(); k++)
+		{
+			AllocRequest request;
+			request.input = reservations[k].input;
+			request.vc = reservations[k].vc;
+			request.out_vc = reservations[k].out_vc;
+			request.output = channel;
+			request.current = (k == 0);
+			request.ready = !buffer_from_tile[request.input][request.vc].IsEmpty() &&
+				!init[channel]->buffer_tx.IsFull();
+			if (!buffer_from_tile[request.input][request.vc].IsEmpty())
+				request.setPriority(buffer_from_tile[request.input][request.vc].Front());
+			requests.push_back(request);
+		}
+	}
+
+	return requests;
+}
+
 void Hub::tileToAntennaProcess()
 {
 	// double cycle = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
@@ -451,6 +668,7 @@ void Hub::tileToAntennaProcess()
 			ack_rx[i]->write(0);
 			buffer_full_status_rx[i].write(bfs);
 			current_level_rx[i] = 0;
+			link_rx[i].reset();
 		}
 		return;
 	}
@@ -467,6 +685,8 @@ void Hub::tileToAntennaProcess()
 			txRadioProcessTokenHold(channel);
 		else if (macPolicy == TOKEN_MAX_HOLD)
 			txRadioProcessTokenMaxHold(channel);
+		else if (macPolicy == SPATIAL_REUSE)
+			txRadioProcessSpatialReuse(channel);
 		else
 			assert(false);
 	}
@@ -503,6 +723,7 @@ void Hub::tileToAntennaProcess()
 					TReservation r;
 					r.input = i;
 					r.vc = vc;
+					r.out_vc = vc;
 
 					assert(r_from_tile[i][vc]==DIRECTION_WIRELESS);
 					int channel;
@@ -547,62 +768,62 @@ void Hub::tileToAntennaProcess()
 		start_from_port = (last_reserved+1)%num_ports;
 
 	// 2nd phase: Forwarding
-	for (int i = 0; i < num_ports; i++)
+	vector<AllocRequest> tx_grants = allocator->allocate(tile2antenna_allocator_state, tileToAntennaRequests());
+
+	for (unsigned int g = 0; g < tx_grants.size(); g++)
 	{
-		vector<pair<int,int> > reservations = tile2antenna_reservation_table.getReservations(i);
+		int i = tx_grants[g].input;
+		int o = tx_grants[g].output;
+		int vc = tx_grants[g].vc;
 
-		if (reservations.size()!=0)
+		if (!buffer_from_tile[i][vc].IsEmpty())
 		{
-			int rnd_idx = rand()%reservations.size();
-
-			int o = reservations[rnd_idx].first;
-			int vc = reservations[rnd_idx].second;
-
-			if (!buffer_from_tile[i][vc].IsEmpty())
-			{
-				Flit flit = buffer_from_tile[i][vc].Front();
-				// powerFront already accounted in 1st phase
+			Flit flit = buffer_from_tile[i][vc].Front();
+			// powerFront already accounted in 1st phase
 
-				assert(r_from_tile[i][vc] == DIRECTION_WIRELESS);
+			assert(r_from_tile[i][vc] == DIRECTION_WIRELESS);
 
-				int channel =  o;
+			int channel =  o;
 
-				if (channel != NOT_RESERVED)
+			if (channel != NOT_RESERVED)
+			{
+				if (!(init[channel]->buffer_tx.IsFull()) )
 				{
-					if (!(init[channel]->buffer_tx.IsFull()) )
+					buffer_from_tile[i][vc].Pop();
+					power.bufferFromTilePop();
+					if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+						link_rx[i].returnCredit(vc);
+					init[channel]->buffer_tx.Push(flit);
+					power.antennaBufferPush();
+					if (flit.flit_type == FLIT_TYPE_TAIL)
 					{
-						buffer_from_tile[i][vc].Pop();
-						power.bufferFromTilePop();
-						init[channel]->buffer_tx.Push(flit);
-						power.antennaBufferPush();
-						if (flit.flit_type == FLIT_TYPE_TAIL)
-						{
-							TReservation r;
-							r.input = i;
-							r.vc = vc;
-							tile2antenna_reservation_table.release(r,channel);
-						}
-
-						LOG << "Flit " << flit << " moved from buffer_from_tile["<<i<<"]["<<vc<<"]  to buffer_tx["<<channel<<"] " << endl;
-					}
-					else
-					{
-						LOG << "Buffer Full: Cannot move flit " << flit << " from buffer_from_tile["<<i<<"] to buffer_tx["<<channel<<"] " << endl;
-						//init[channel]->buffer_tx.Print();
+						TReservation r;
+						r.input = i;
+						r.vc = vc;
+						tile2antenna_reservation_table.release(r,channel);
 					}
+
+					LOG << "Flit " << flit << " moved from buffer_from_tile["<<i<<"]["<<vc<<"]  to buffer_tx["<<channel<<"] " << endl;
 				}
 				else
 				{
-					LOG << "Forwarding: No channel reserved for input port [" << i << "][" << vc << "], flit " << flit << endl;
+					LOG << "Buffer Full: Cannot move flit " << flit << " from buffer_from_tile["<<i<<"] to buffer_tx["<<channel<<"] " << endl;
+					//init[channel]->buffer_tx.Print();
 				}
 			}
-
-		}// for all the ports
-	}
+			else
+			{
+				LOG << "Forwarding: No channel reserved for input port [" << i << "][" << vc << "], flit " << flit << endl;
+			}
+		}
+	} // for all the grants
 
 	for (int i = 0; i < num_ports; i++)
 	{
 
+		if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+			creditRx(i);
+		else
 		if (req_rx[i]->read() == 1 - current_level_rx[i])
 		{
 			Flit received_flit = flit_rx[i]->read();
@@ -637,6 +858,7 @@ void Hub::tileToAntennaProcess()
 		TBufferFullStatus bfs;
 		for (int vc=0;vc<GlobalParams::n_virtual_channels;vc++)
 			bfs.mask[vc] = buffer_from_tile[i][vc].IsFull();
+		link_rx[i].writeCredit(bfs);
 		buffer_full_status_rx[i].write(bfs);
 	}
 
@@ -645,6 +867,36 @@ void Hub::tileToAntennaProcess()
 	updateTxPower();
 }
 
+bool Hub::portReady(int port, int vc)
+{
+	if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+		return link_tx[port].hasCredit(vc);
+
+	return current_level_tx[port] == ack_tx[port].read() &&
+		buffer_full_status_tx[port].read().mask[vc] == false;
+}
+
+void Hub::creditRx(int port)
+{
+	if (req_rx[port]->read() == 1 - current_level_rx[port])
+	{
+		link_rx[port].receive(flit_rx[port]->read());
+		current_level_rx[port] = 1 - current_level_rx[port];
+	}
+
+	while (link_rx[port].flitArrived())
+	{
+		Flit received_flit = link_rx[port].popFlit();
+		int vc = received_flit.vc_id;
+
+		assert(!buffer_from_tile[port][vc].IsFull());
+		LOG << "Storing " << received_flit << " on buffer_from_tile[" << port << "][" << vc << "]" << endl;
+
+		buffer_from_tile[port][vc].Push(received_flit);
+		power.bufferFromTilePush();
+	}
+}
+
 int Hub::selectChannel(int src_hub, int dst_hub) const
 {
 	vector<int> & first = GlobalParams::hub_configuration[src_hub].txChannels;
@@ -16,6 +16,9 @@
 #include "DataStructs.h"
 #include "Buffer.h"
 #include "ReservationTable.h"
+#include "FlowControl.h"
+#include "allocators/Allocator.h"
+#include "allocators/Allocators.h"
 
 #include "Initiator.h"
 #include "Target.h"
@@ -24,6 +27,12 @@
 
 using namespace std;
 
+struct Channel;
+
+#define IDLE_HISTOGRAM_BINS 24
+// observed idle intervals required before predicting
+#define IDLE_MIN_SAMPLES 8
+
 SC_MODULE(Hub)
 {
     SC_HAS_PROCESS(Hub);
@@ -53,6 +62,8 @@ SC_MODULE(Hub)
     BufferBank* buffer_to_tile;     // Buffer for each port
     bool* current_level_rx;	// Current level for ABP
     bool* current_level_tx;	// Current level for ABP
+    LinkReceiver* link_rx;	// Input link pipelines (credit based flow control)
+    LinkSender* link_tx;	// Output credits (credit based flow control)
 
 
     map<int, sc_in<int>* > current_token_holder;
@@ -62,6 +73,7 @@ SC_MODULE(Hub)
 
     map<int, Initiator*> init;
     map<int, Target*> target;
+    map<int, Channel*> radio_channel; // tx channels, used by SPATIAL_REUSE
 
     map<int, int> tile2port_mapping;
     map<int, int> tile2hub_mapping;
@@ -72,6 +84,10 @@ SC_MODULE(Hub)
     ReservationTable antenna2tile_reservation_table;	// Switch reservation table
     ReservationTable tile2antenna_reservation_table;// Wireless reservation table
 
+    Allocator * allocator;
+    AllocatorState antenna2tile_allocator_state;
+    AllocatorState tile2antenna_allocator_state;
+
     void updateRxPower();
     void updateTxPower();
     void antennaToTileProcess();
@@ -80,6 +96,11 @@ SC_MODULE(Hub)
     int route(Flit&);
     int tile2Port(int);
 
+    // Estimated number of cycles required to send a packet of
+    // packet_size flits to dst_hub, given the current hub queues
+    // and token position
+    int estimateWirelessCycles(int dst_hub, int packet_size);
+
     void setFlitTransmissionCycles(int cycles,int ch_id) {flit_transmission_cycles[ch_id]=cycles;}
 
     // Power stats
@@ -94,6 +115,23 @@ SC_MODULE(Hub)
 
     int wireless_communications_counter;
 
+    // Predictive power manager
+    void notifyReception(const Flit & flit);
+    int rxWakeUp();
+
+    int predictive_sleep_cycles;   // cycles slept in predicted idle windows
+    int rx_wakeups;                // receivers woken up by an incoming flit
+    int rx_wakeup_penalty_cycles;  // latency added by the wake-ups
+
+    // Wireless retransmission stats
+    int wireless_tx_flits;          // flits sent over the radio, retransmissions included
+    int wireless_retransmissions;   // flits NACKed by the receiver CRC check
+    int wireless_retransmission_cycles; // channel cycles spent on NACKed flits and ACK timeouts
+    double wireless_retransmission_energy;
+    int wireless_residual_errors;   // corrupted flits delivered after the retry limit
+
+    int getFlitTransmissionCycles(int ch_id) { return flit_transmission_cycles[ch_id]; }
+
     // Constructor
 
     Hub(sc_module_name nm, int id, TokenRing * tr): sc_module(nm) {
@@ -123,6 +161,17 @@ SC_MODULE(Hub)
 #define STATIC_MAX_CHANNELS 100
       tile2antenna_reservation_table.setSize(STATIC_MAX_CHANNELS);
 
+	allocator = Allocators::get(GlobalParams::allocator);
+
+	if (allocator == 0)
+	{
+	    cerr << " FATAL: invalid allocator -alloc " << GlobalParams::allocator << ", check with noxim -help" << endl;
+	    exit(-1);
+	}
+
+	antenna2tile_allocator_state.setSize(STATIC_MAX_CHANNELS, num_ports, GlobalParams::n_virtual_channels);
+	tile2antenna_allocator_state.setSize(num_ports, STATIC_MAX_CHANNELS, GlobalParams::n_virtual_channels);
+
         flit_rx = new sc_in<Flit>[num_ports];
         req_rx = new sc_in<bool>[num_ports];
         ack_rx = new sc_out<bool>[num_ports];
@@ -142,6 +191,9 @@ SC_MODULE(Hub)
         current_level_rx = new bool[num_ports];
         current_level_tx = new bool[num_ports];
 
+        link_rx = new LinkReceiver[num_ports];
+        link_tx = new LinkSender[num_ports];
+
         start_from_port = 0;
 
         for(int i = 0; i < num_ports; i++)
@@ -154,6 +206,7 @@ SC_MODULE(Hub)
                 buffer_to_tile[i][vc].setLabel(string(name())+"->btt["+i_to_string(i)+"]["+i_to_string(vc)+"]");
             }
             start_from_vc[i] = 0;
+            link_rx[i].setStages(linkStages(GlobalParams::r2h_link_stages, GlobalParams::r2h_link_length));
         }
 
         for (unsigned int i = 0; i < txChannels.size(); i++) {
@@ -168,9 +221,6 @@ SC_MODULE(Hub)
             flag[ch] = new sc_inout<int>();
             token_ring->attachHub(ch,local_id, current_token_holder[ch],current_token_expiration[ch],flag[ch]);
             transmission_in_progress[ch] = false;
-            // power manager currently assumes TOKEN_PACKET mac policy
-            if (GlobalParams::use_powermanager)
-                assert(token_ring->getPolicy(ch).first==TOKEN_PACKET);
         }
 
         for (unsigned int i = 0; i < rxChannels.size(); i++) {
@@ -185,6 +235,20 @@ SC_MODULE(Hub)
 	total_sleep_cycles = 0;
 	total_ttxoff_cycles = 0;
 	wireless_communications_counter = 0;
+
+	predictive_sleep_cycles = 0;
+	rx_wakeups = 0;
+	rx_wakeup_penalty_cycles = 0;
+	wireless_tx_flits = 0;
+	wireless_retransmissions = 0;
+	wireless_retransmission_cycles = 0;
+	wireless_retransmission_energy = 0.0;
+	wireless_residual_errors = 0;
+	last_reception_cycle = NOT_VALID;
+	predictive_sleep_end = NOT_VALID;
+	idle_samples = 0;
+	for (int i = 0; i < IDLE_HISTOGRAM_BINS; i++)
+	    idle_histogram[i] = 0;
     }
 
 
@@ -196,10 +260,33 @@ SC_MODULE(Hub)
     void txRadioProcessTokenPacket(int channel);
     void txRadioProcessTokenHold(int channel);
     void txRadioProcessTokenMaxHold(int channel);
+    void txRadioProcessSpatialReuse(int channel);
 
     void rxPowerManager();
     void txPowerManager();
 
+    // reserved inputs/VCs waiting for their output, for the allocator
+    vector<AllocRequest> antennaToTileRequests();
+    vector<AllocRequest> tileToAntennaRequests();
+
+    // true when a flit of vc can be sent to the tile on port
+    bool portReady(int port, int vc);
+
+    // samples port and moves the flits leaving its link pipeline to
+    // buffer_from_tile (credit based flow control)
+    void creditRx(int port);
+
+    // idle intervals between receptions: bin k counts intervals in [2^k, 2^(k+1))
+    int idle_histogram[IDLE_HISTOGRAM_BINS];
+    int idle_samples;
+    int last_reception_cycle;
+    int predictive_sleep_end;
+    int predictIdleCycles() const;
+
+    // average number of cycles needed to deliver a flit on channel,
+    // including the expected retransmissions
+    double expectedFlitCycles(int channel);
+
     int selectChannel(int src, int dst) const ;
 };
 
@@ -9,6 +9,7 @@
  */
 #include "Hub.h"
 #include "Initiator.h"
+#include "Channel.h"
 
 void Initiator::thread_process()
 {
@@ -71,9 +72,20 @@ void Initiator::thread_process()
 		socket->b_transport( *trans, delay);
 
 		hub->power.wirelessTx(hub->local_id,destHub,GlobalParams::flit_size);
+		hub->wireless_tx_flits++;
 
 		// Initiator obliged to check response status and delay
-		if (!trans->is_response_error() )
+		if (trans->get_response_status() == tlm::TLM_GENERIC_ERROR_RESPONSE)
+		{
+			// NACK: the flit is kept in buffer_tx and retransmitted
+			// once the ACK timeout expires
+			LOG << " NACK received for " << flit_payload << ", retransmitting" << endl;
+			hub->wireless_retransmissions++;
+			hub->wireless_retransmission_cycles += hub->getFlitTransmissionCycles(_channel_id) + GlobalParams::wireless_retry_timeout;
+			hub->wireless_retransmission_energy += hub->power.getWirelessFlitEnergy();
+			wait(sc_time(GlobalParams::wireless_retry_timeout * GlobalParams::clock_period_ps, SC_PS));
+		}
+		else if (!trans->is_response_error() )
 		{
 			buffer_tx.Pop();
 			hub->power.antennaBufferPop();
@@ -86,6 +98,9 @@ void Initiator::thread_process()
 				LOG << "*** [Ch"<< _channel_id <<"] tail flit sent " << flit_payload << ", releasing token" << endl;
 				hub->flag[_channel_id]->write(RELEASE_CHANNEL);
 				hub->transmission_in_progress.at(_channel_id) = false;
+
+				if (GlobalParams::channel_configuration[_channel_id].macPolicy[0] == SPATIAL_REUSE)
+					hub->radio_channel[_channel_id]->releaseTransmission(hub->local_id);
 			}
 		}
 		else
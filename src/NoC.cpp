@@ -32,6 +32,7 @@ void NoC::buildCommon()
 		int channel_id = it->first;
 		sprintf(channel_name, "Channel_%d", channel_id);
 		channel[channel_id] = new Channel(channel_name, channel_id);
+		channel[channel_id]->token_ring = token_ring;
 	}
 
 	char hub_name[16];
@@ -69,6 +70,7 @@ void NoC::buildCommon()
 			int channel_id = *iit;
 			//LOG << "Binding " << hub[hub_id]->name() << " to txChannel " << channel_id << endl;
 			hub[hub_id]->init[channel_id]->socket.bind(channel[channel_id]->targ_socket);
+			hub[hub_id]->radio_channel[channel_id] = channel[channel_id];
 			//LOG << "Binding " << hub[hub_id]->name() << " to txChannel " << channel_id << endl;
 			hub[hub_id]->setFlitTransmissionCycles(channel[channel_id]->getFlitTransmissionCycles(),channel_id);
 		}
@@ -116,9 +118,36 @@ void NoC::buildCommon()
 	if (GlobalParams::routing_algorithm == ROUTING_TABLE_BASED)
 		assert(grtable.load(GlobalParams::routing_table_filename.c_str()));
 
-	// Check for traffic table availability
+	// Check for traffic table availability, or build it from the
+	// traffic_table_patterns
 	if (GlobalParams::traffic_distribution == TRAFFIC_TABLE_BASED)
-		assert(gttable.load(GlobalParams::traffic_table_filename.c_str()));
+	{
+		if (!GlobalParams::traffic_table_patterns.empty())
+		{
+			if (!gttable.generate(GlobalParams::traffic_table_patterns))
+				exit(1);
+		}
+		else
+			assert(gttable.load(GlobalParams::traffic_table_filename.c_str()));
+	}
+
+	// Map the trace to be replayed
+	if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+	{
+		int n_nodes = (GlobalParams::topology == TOPOLOGY_MESH) ?
+			GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y : GlobalParams::n_delta_tiles;
+		if (!trace_replay.load(GlobalParams::trace_replay_filename.c_str(), n_nodes))
+			exit(1);
+	}
+
+	// Load the application task graph
+	if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+	{
+		int n_nodes = (GlobalParams::topology == TOPOLOGY_MESH) ?
+			GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y : GlobalParams::n_delta_tiles;
+		if (!task_graph.load(GlobalParams::task_graph_filename.c_str(), n_nodes))
+			exit(1);
+	}
 
 	// Var to track Hub connected ports
 	hub_connected_ports = (int *) calloc(GlobalParams::hub_configuration.size(), sizeof(int));
@@ -235,6 +264,7 @@ void NoC::buildButterfly()
 				int port = hub_connected_ports[hub_id]++;
 
 				hub[hub_id]->tile2port_mapping[t[i][j]->local_id] = port;
+				t[i][j]->r->hub = hub[hub_id];
 
 				hub[hub_id]->req_rx[port](req[i][j].to_hub);
 				hub[hub_id]->flit_rx[port](flit[i][j].to_hub);
@@ -536,6 +566,16 @@ void NoC::buildButterfly()
 			core[i]->pe->traffic_table = &gttable;	// Needed to choose destination
 			core[i]->pe->never_transmit = (gttable.occurrencesAsSource(core[i]->pe->local_id) == 0);
 		}
+		else if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+		{
+			core[i]->pe->trace_replay = &trace_replay;
+			core[i]->pe->never_transmit = (trace_replay.occurrencesAsSource(core[i]->pe->local_id) == 0);
+		}
+		else if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+		{
+			core[i]->pe->task_graph = &task_graph;
+			core[i]->pe->never_transmit = (task_graph.occurrencesAsTile(core[i]->pe->local_id) == 0);
+		}
 		else
 			core[i]->pe->never_transmit = false;
 
@@ -559,6 +599,7 @@ void NoC::buildButterfly()
 			int port = hub_connected_ports[hub_id]++;
 			//LOG<<"I am hub "<<hub_id<<" connecting to core "<<core_id<<"using port "<<port<<endl;
 			hub[hub_id]->tile2port_mapping[core[i]->local_id] = port;
+			core[i]->r->hub = hub[hub_id];
 
 			hub[hub_id]->req_rx[port](req_to_hub[core_id]);
 			hub[hub_id]->flit_rx[port](flit_to_hub[core_id]);
@@ -885,6 +926,7 @@ void NoC::buildBaseline()
 		int port = hub_connected_ports[hub_id]++;
 
 		hub[hub_id]->tile2port_mapping[t[i][j]->local_id] = port;
+		t[i][j]->r->hub = hub[hub_id];
 
 		hub[hub_id]->req_rx[port](req[i][j].to_hub);
 		hub[hub_id]->flit_rx[port](flit[i][j].to_hub);
@@ -1299,6 +1341,16 @@ void NoC::buildBaseline()
 	    core[i]->pe->traffic_table = &gttable;	// Needed to choose destination
 	    core[i]->pe->never_transmit = (gttable.occurrencesAsSource(core[i]->pe->local_id) == 0);
 	}
+	else if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+	{
+	    core[i]->pe->trace_replay = &trace_replay;
+	    core[i]->pe->never_transmit = (trace_replay.occurrencesAsSource(core[i]->pe->local_id) == 0);
+	}
+	else if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+	{
+	    core[i]->pe->task_graph = &task_graph;
+	    core[i]->pe->never_transmit = (task_graph.occurrencesAsTile(core[i]->pe->local_id) == 0);
+	}
 	else
 	    core[i]->pe->never_transmit = false;
 
@@ -1318,6 +1370,7 @@ void NoC::buildBaseline()
 			int port = hub_connected_ports[hub_id]++;
 			//LOG<<"I am hub "<<hub_id<<" connecting to core "<<core_id<<"using port "<<port<<endl;
 			hub[hub_id]->tile2port_mapping[core[i]->local_id] = port;
+			core[i]->r->hub = hub[hub_id];
 
 			hub[hub_id]->req_rx[port](req_to_hub[core_id]);
 			hub[hub_id]->flit_rx[port](flit_to_hub[core_id]);
@@ -1615,6 +1668,7 @@ void NoC::buildOmega()
 				int port = hub_connected_ports[hub_id]++;
 
 				hub[hub_id]->tile2port_mapping[t[i][j]->local_id] = port;
+				t[i][j]->r->hub = hub[hub_id];
 
 				hub[hub_id]->req_rx[port](req[i][j].to_hub);
 				hub[hub_id]->flit_rx[port](flit[i][j].to_hub);
@@ -1929,6 +1983,16 @@ void NoC::buildOmega()
 			core[i]->pe->traffic_table = &gttable;	// Needed to choose destination
 			core[i]->pe->never_transmit = (gttable.occurrencesAsSource(core[i]->pe->local_id) == 0);
 		}
+		else if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+		{
+			core[i]->pe->trace_replay = &trace_replay;
+			core[i]->pe->never_transmit = (trace_replay.occurrencesAsSource(core[i]->pe->local_id) == 0);
+		}
+		else if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+		{
+			core[i]->pe->task_graph = &task_graph;
+			core[i]->pe->never_transmit = (task_graph.occurrencesAsTile(core[i]->pe->local_id) == 0);
+		}
 		else
 			core[i]->pe->never_transmit = false;
 
@@ -1948,6 +2012,7 @@ void NoC::buildOmega()
 			int port = hub_connected_ports[hub_id]++;
 			//LOG<<"I am hub "<<hub_id<<" connecting to core "<<core_id<<"using port "<<port<<endl;
 			hub[hub_id]->tile2port_mapping[core[i]->local_id] = port;
+			core[i]->r->hub = hub[hub_id];
 
 			hub[hub_id]->req_rx[port](req_to_hub[core_id]);
 			hub[hub_id]->flit_rx[port](flit_to_hub[core_id]);
@@ -2207,6 +2272,16 @@ void NoC::buildMesh()
 			 t[i][j]->pe->traffic_table = &gttable;	// Needed to choose destination
 	   		 t[i][j]->pe->never_transmit = (gttable.occurrencesAsSource(t[i][j]->pe->local_id) == 0);
 		}
+		else if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+		{
+			 t[i][j]->pe->trace_replay = &trace_replay;
+			 t[i][j]->pe->never_transmit = (trace_replay.occurrencesAsSource(t[i][j]->pe->local_id) == 0);
+		}
+		else if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+		{
+			 t[i][j]->pe->task_graph = &task_graph;
+			 t[i][j]->pe->never_transmit = (task_graph.occurrencesAsTile(t[i][j]->pe->local_id) == 0);
+		}
 		else
 			t[i][j]->pe->never_transmit = false;
 
@@ -2280,6 +2355,7 @@ void NoC::buildMesh()
             int port = hub_connected_ports[hub_id]++;
 
             hub[hub_id]->tile2port_mapping[t[i][j]->local_id] = port;
+            t[i][j]->r->hub = hub[hub_id];
 
             hub[hub_id]->req_rx[port](req[i][j].to_hub);
             hub[hub_id]->flit_rx[port](flit[i][j].to_hub);
@@ -2317,6 +2393,20 @@ void NoC::buildMesh()
 	}
     }
 
+    // Router adjacency, used by lookahead routing
+    for (int j = 0; j < GlobalParams::mesh_dim_y; j++) {
+	for (int i = 0; i < GlobalParams::mesh_dim_x; i++) {
+	    if (j > 0)
+		t[i][j]->r->neighbor[DIRECTION_NORTH] = t[i][j - 1]->r;
+	    if (i < GlobalParams::mesh_dim_x - 1)
+		t[i][j]->r->neighbor[DIRECTION_EAST] = t[i + 1][j]->r;
+	    if (j < GlobalParams::mesh_dim_y - 1)
+		t[i][j]->r->neighbor[DIRECTION_SOUTH] = t[i][j + 1]->r;
+	    if (i > 0)
+		t[i][j]->r->neighbor[DIRECTION_WEST] = t[i - 1][j]->r;
+	}
+    }
+
     // dummy NoP_data structure
     NoP_data tmp_NoP;
 
@@ -15,6 +15,8 @@
 #include "Tile.h"
 #include "GlobalRoutingTable.h"
 #include "GlobalTrafficTable.h"
+#include "TraceReplay.h"
+#include "TaskGraph.h"
 #include "Hub.h"
 #include "Channel.h"
 #include "TokenRing.h"
@@ -86,6 +88,8 @@ SC_MODULE(NoC)
     // Global tables
     GlobalRoutingTable grtable;
     GlobalTrafficTable gttable;
+    TraceReplay trace_replay;
+    TaskGraph task_graph;
 
 
     // Constructor
@@ -0,0 +1,82 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the source queue of the
+ * processing elements
+ */
+
+#ifndef __NOXIMPACKETQUEUE_H__
+#define __NOXIMPACKETQUEUE_H__
+
+#include <cassert>
+#include <vector>
+#include "DataStructs.h"
+
+using namespace std;
+
+// FIFO of packets over a pool of slots which are reused, and never
+// released, as packets are pushed and popped. The pool only grows when
+// a push finds every slot busy, so a bounded queue allocates its
+// capacity once, at reset
+class PacketQueue {
+
+  public:
+
+    PacketQueue() {
+	reset(0);
+    }
+
+    // Empties the queue. capacity is the size full() refers to, 0 for
+    // an unbounded queue
+    void reset(const unsigned int _capacity) {
+	capacity = _capacity;
+	head = 0;
+	count = 0;
+	if (slots.size() < capacity)
+	    slots.resize(capacity);
+    }
+
+    bool empty() const { return count == 0; }
+    unsigned int size() const { return count; }
+    bool full() const { return capacity > 0 && count >= capacity; }
+
+    Packet & front() {
+	assert(count > 0);
+	return slots[head];
+    }
+
+    void push(const Packet & packet) {
+	if (count == slots.size())
+	    grow();
+	slots[(head + count) % slots.size()] = packet;
+	count++;
+    }
+
+    void pop() {
+	assert(count > 0);
+	head = (head + 1) % slots.size();
+	count--;
+    }
+
+  private:
+
+    // Doubles the pool, moving the queued packets at its beginning
+    void grow() {
+	vector < Packet > larger(slots.empty() ? 16 : 2 * slots.size());
+	for (unsigned int i = 0; i < count; i++)
+	    larger[i] = slots[(head + i) % slots.size()];
+	slots.swap(larger);
+	head = 0;
+    }
+
+    vector < Packet > slots;
+    unsigned int head;		// slot of the front packet
+    unsigned int count;		// packets queued
+    unsigned int capacity;	// 0 if unbounded
+};
+
+#endif
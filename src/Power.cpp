@@ -83,20 +83,17 @@ void Power::configureRouter(int link_width,
 // (s)tatic, (d)ynamic power
 
     // Buffer 
-    pair<int,int> key = pair<int,int>(buffer_depth, buffer_item_size);
-    
-    assert(GlobalParams::power_configuration.bufferPowerConfig.leakage.find(key) != GlobalParams::power_configuration.bufferPowerConfig.leakage.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.push.find(key) != GlobalParams::power_configuration.bufferPowerConfig.push.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.front.find(key) != GlobalParams::power_configuration.bufferPowerConfig.front.end());
-    assert(GlobalParams::power_configuration.bufferPowerConfig.pop.find(key) != GlobalParams::power_configuration.bufferPowerConfig.pop.end());
+    // a DAMQ port is a single buffer holding the slots of all its VCs
+    if (GlobalParams::buffer_organization == BUFFER_DAMQ)
+	buffer_depth *= GlobalParams::n_virtual_channels;
 
     // Dynamic values are expressed in Joule
     // Static/Leakage values must be converted from Watt to Joule
 
-    buffer_router_pwr_s = W2J(GlobalParams::power_configuration.bufferPowerConfig.leakage[key]);
-    buffer_router_push_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.push[key];
-    buffer_router_front_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.front[key];
-    buffer_router_pop_pwr_d = GlobalParams::power_configuration.bufferPowerConfig.pop[key];
+    buffer_router_pwr_s = W2J(bufferEnergy(GlobalParams::power_configuration.bufferPowerConfig.leakage, buffer_depth, buffer_item_size));
+    buffer_router_push_pwr_d = bufferEnergy(GlobalParams::power_configuration.bufferPowerConfig.push, buffer_depth, buffer_item_size);
+    buffer_router_front_pwr_d = bufferEnergy(GlobalParams::power_configuration.bufferPowerConfig.front, buffer_depth, buffer_item_size);
+    buffer_router_pop_pwr_d = bufferEnergy(GlobalParams::power_configuration.bufferPowerConfig.pop, buffer_depth, buffer_item_size);
 
     // Routing 
     assert(GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm.find(routing_function) != GlobalParams::power_configuration.routerPowerConfig.routing_algorithm_pm.end());
@@ -136,6 +133,40 @@ void Power::configureRouter(int link_width,
     link_r2h_pwr_d= link_width * GlobalParams::power_configuration.linkBitLinePowerConfig[length_r2h].second;
 }
 
+double Power::bufferEnergy(const map<pair<int,int>, double> & m, int depth, int item_size) const
+{
+    map<pair<int,int>, double>::const_iterator it = m.find(pair<int,int>(depth, item_size));
+    if (it != m.end())
+	return it->second;
+
+    // depth not characterized: linear interpolation between the closest
+    // characterized depths for the same item size, or linear scaling of
+    // the closest one when depth is out of the characterized range
+    int lower = NOT_VALID, upper = NOT_VALID;
+    for (it = m.begin(); it != m.end(); ++it)
+    {
+	if (it->first.second != item_size)
+	    continue;
+	int d = it->first.first;
+	if (d < depth && (lower == NOT_VALID || d > lower))
+	    lower = d;
+	if (d > depth && (upper == NOT_VALID || d < upper))
+	    upper = d;
+    }
+
+    assert(lower != NOT_VALID || upper != NOT_VALID);
+
+    if (lower == NOT_VALID)
+	return m.find(pair<int,int>(upper, item_size))->second * depth / upper;
+    if (upper == NOT_VALID)
+	return m.find(pair<int,int>(lower, item_size))->second * depth / lower;
+
+    double e_lower = m.find(pair<int,int>(lower, item_size))->second;
+    double e_upper = m.find(pair<int,int>(upper, item_size))->second;
+
+    return e_lower + (e_upper - e_lower) * (depth - lower) / (upper - lower);
+}
+
 void Power::configureHub(int link_width,
 	int buffer_to_tile_depth, // buffer to tile
 	int buffer_from_tile_depth, // buffer from tile
@@ -446,6 +477,11 @@ void Power::leakageRouter()
 
 
 
+void Power::powerGating(double energy)
+{
+    power_dynamic.breakdown[POWER_GATING_PWR_D].value += energy;
+}
+
 void Power::leakageTransceiverRx()
 {
 
@@ -474,6 +510,12 @@ void Power::rxSleep(int cycles)
 }
 
 
+void Power::rxWakeUp()
+{
+    sleep_end_cycle = (int)(sc_time_stamp().to_double()/GlobalParams::clock_period_ps);
+}
+
+
 bool Power::isSleeping()
 {
     assert(GlobalParams::use_powermanager);
@@ -518,6 +560,7 @@ void Power::initPowerBreakdown()
     initPowerBreakdownEntry(&power_dynamic.breakdown[WIRELESS_TX],"wireless_tx");
     initPowerBreakdownEntry(&power_dynamic.breakdown[WIRELESS_DYNAMIC_RX_PWR],"wireless_dynamic_rx_pwr");
     initPowerBreakdownEntry(&power_dynamic.breakdown[WIRELESS_SNOOPING],"wireless_snooping");
+    initPowerBreakdownEntry(&power_dynamic.breakdown[POWER_GATING_PWR_D],"power_gating_pwr_d");
 
     initPowerBreakdownEntry(&power_static.breakdown[TRANSCEIVER_RX_PWR_BIASING],"transceiver_rx_pwr_biasing");
     initPowerBreakdownEntry(&power_static.breakdown[TRANSCEIVER_TX_PWR_BIASING],"transceiver_tx_pwr_biasing");
@@ -94,8 +94,27 @@ class Power {
     PowerBreakdown* getStaticPowerBreakDown(){ return &power_static;}
 
     void rxSleep(int cycles);
+    void rxWakeUp();
     bool isSleeping();
 
+    // energy spent by the sleep transistors to gate and wake up the router
+    void powerGating(double energy);
+
+    // energy spent in a cycle by an idle (not sleeping) receiver
+    double getRxIdleEnergy() const {
+	return wireless_snooping + transceiver_rx_pwr_s + transceiver_rx_pwr_biasing;
+    }
+
+    // energy spent to send a flit over the radio and receive it
+    double getWirelessFlitEnergy() const {
+	return default_tx_energy + wireless_rx_pwr;
+    }
+
+    // energy leaked in a cycle by a powered router with n_buffers input buffers
+    double getRouterLeakage(int n_buffers) const {
+	return routing_pwr_s + selection_pwr_s + crossbar_pwr_s + ni_pwr_s + n_buffers * buffer_router_pwr_s;
+    }
+
   private:
 
     double total_power_s;
@@ -149,6 +168,10 @@ class Power {
     map< pair<int, int> , double>  attenuation_map;
     double attenuation2power(double);
 
+    // energy of a buffer of depth flits of item_size bits, interpolated
+    // when depth is not characterized in m
+    double bufferEnergy(const map<pair<int,int>, double> & m, int depth, int item_size) const;
+
 
     void printBreakDown(string label, const map<string,double> & m,std::ostream & out) const;
 
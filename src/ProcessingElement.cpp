@@ -10,10 +10,18 @@
 
 #include "ProcessingElement.h"
 
+// The traffic is drawn from a stream of the PE, apart from the random
+// decisions of the network: for a given seed every configuration of the
+// network is offered the same packets (common random numbers)
+int ProcessingElement::nextRandom()
+{
+    return rand_r(&rng_state);
+}
+
 int ProcessingElement::randInt(int min, int max)
 {
     return min +
-	(int) ((double) (max - min + 1) * rand() / (RAND_MAX + 1.0));
+	(int) ((double) (max - min + 1) * nextRandom() / (RAND_MAX + 1.0));
 }
 
 void ProcessingElement::rxProcess()
@@ -21,12 +29,42 @@ void ProcessingElement::rxProcess()
     if (reset.read()) {
 	ack_rx.write(0);
 	current_level_rx = 0;
+	link_rx.reset();
+	buffer_full_status_rx.write(TBufferFullStatus());
     } else {
 	if (req_rx.read() == 1 - current_level_rx) {
 	    Flit flit_tmp = flit_rx.read();
 	    current_level_rx = 1 - current_level_rx;	// Negate the old value for Alternating Bit Protocol (ABP)
+
+	    // releases the trace packets depending on this one
+	    if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY &&
+		flit_tmp.flit_type == FLIT_TYPE_TAIL && flit_tmp.trace_id != NOT_VALID)
+		trace_replay->delivered(flit_tmp.trace_id);
+
+	    if (GlobalParams::traffic_distribution == TRAFFIC_CLOSED_LOOP &&
+		flit_tmp.flit_type == FLIT_TYPE_TAIL && flit_tmp.transaction != TRANSACTION_NONE)
+		transactionReceived(flit_tmp);
+
+	    if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH &&
+		flit_tmp.flit_type == FLIT_TYPE_TAIL && flit_tmp.task_edge != NOT_VALID)
+	    {
+		int task = task_graph->packetDelivered(flit_tmp.task_edge);
+		if (task != NOT_VALID)
+		    ready_tasks.push(task);
+	    }
+
+	    // flits are consumed as soon as they are received
+	    if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+		link_rx.returnCredit(flit_tmp.vc_id);
 	}
 	ack_rx.write(current_level_rx);
+
+	if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+	{
+	    TBufferFullStatus bfs;
+	    link_rx.writeCredit(bfs);
+	    buffer_full_status_rx.write(bfs);
+	}
     }
 }
 
@@ -36,16 +74,94 @@ void ProcessingElement::txProcess()
 	req_tx.write(0);
 	current_level_tx = 0;
 	transmittedAtPreviousCycle = false;
+	link_tx.reset(routerInputPool());
+	rng_state = (unsigned int) GlobalParams::rnd_generator_seed * 2654435761u + local_id * 40503u + 1;
+	traffic_signature = 14695981039346656037ULL;
+	profile = GlobalParams::node_traffic_profile[local_id];
+	resetInjection();
+
+	packet_queue.reset(GlobalParams::source_queue_size);
+	injected_packets = 0;
+	offered_flits = 0;
+	accepted_flits = 0;
+	dropped_packets = 0;
+	stalled_cycles = 0;
+	max_queue_size = 0;
+
+	if (!destinations_built)
+	    buildDestinations();
+
+	memory_controller = (find(GlobalParams::memory_controllers.begin(), GlobalParams::memory_controllers.end(),
+				  local_id) != GlobalParams::memory_controllers.end());
+	outstanding = 0;
+	served_replies = queue < Packet >();
+	transactions = 0;
+	round_trip_sum = 0.0;
+	round_trip_max = 0.0;
+
+	ready_tasks = queue < int >();
+	running_task = NOT_VALID;
+	if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+	{
+	    vector < int > initial = task_graph->initialTasks(local_id);
+	    for (unsigned int t = 0; t < initial.size(); t++)
+		ready_tasks.push(initial[t]);
+	}
     } else {
-	Packet packet;
-
-	if (canShot(packet)) {
-	    packet_queue.push(packet);
-	    transmittedAtPreviousCycle = true;
-	} else
+	if (GlobalParams::traffic_distribution == TRAFFIC_TRACE_REPLAY)
+	    replayTrace();
+	else if (GlobalParams::traffic_distribution == TRAFFIC_CLOSED_LOOP)
+	    closedLoopTx();
+	else if (GlobalParams::traffic_distribution == TRAFFIC_TASK_GRAPH)
+	    taskGraphTx();
+	else if (packet_queue.full() && GlobalParams::source_queue_policy == SOURCE_QUEUE_STALL) {
+	    // the source waits for the queue to drain
+	    if (afterWarmUp())
+		stalled_cycles++;
 	    transmittedAtPreviousCycle = false;
+	}
+	else if (!injectionDue())
+	    transmittedAtPreviousCycle = false;
+	else {
+	    Packet packet;
+
+	    if (canShot(packet)) {
+		signPacket(packet);
+
+		bool dropped = packet_queue.full();
+		if (!dropped)
+		    packet_queue.push(packet);
+
+		if (afterWarmUp())
+		{
+		    offered_flits += packet.size;
+		    if (dropped)
+			dropped_packets++;
+		    else
+			accepted_flits += packet.size;
+		}
+		transmittedAtPreviousCycle = true;
+	    } else
+		transmittedAtPreviousCycle = false;
+	}
+
+	if (packet_queue.size() > max_queue_size)
+	    max_queue_size = packet_queue.size();
+
 
+	if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+	{
+	    link_tx.update(buffer_full_status_tx.read());
 
+	    if (!packet_queue.empty() && link_tx.hasCredit(packet_queue.front().vc_id)) {
+		Flit flit = nextFlit();	// Generate a new flit
+		link_tx.consumeCredit(flit.vc_id);
+		flit_tx->write(flit);	// Send the generated flit
+		current_level_tx = 1 - current_level_tx;
+		req_tx.write(current_level_tx);
+	    }
+	}
+	else
 	if (ack_tx.read() == current_level_tx) {
 	    if (!packet_queue.empty()) {
 		Flit flit = nextFlit();	// Generate a new flit
@@ -60,7 +176,16 @@ void ProcessingElement::txProcess()
 Flit ProcessingElement::nextFlit()
 {
     Flit flit;
-    Packet packet = packet_queue.front();
+
+    // the flit is synthesised from the queue head, without copying it
+    Packet & packet = packet_queue.front();
+
+    // the source queuing delay ends when the head enters the network
+    if (packet.flit_left == packet.size)
+    {
+	packet.injection_timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+	packet.packet_id = injected_packets++;
+    }
 
     flit.src_id = packet.src_id;
     flit.dst_id = packet.dst_id;
@@ -69,9 +194,19 @@ Flit ProcessingElement::nextFlit()
     flit.sequence_no = packet.size - packet.flit_left;
     flit.sequence_length = packet.size;
     flit.hop_no = 0;
+    flit.traffic_class = packet.traffic_class;
     //  flit.payload     = DEFAULT_PAYLOAD;
 
     flit.hub_relay_node = NOT_VALID;
+    flit.lookahead_out = NOT_VALID;
+    flit.deflections = 0;
+    flit.dst_set = packet.dst_set;
+    flit.trace_id = packet.trace_id;
+    flit.transaction = packet.transaction;
+    flit.request_timestamp = packet.request_timestamp;
+    flit.task_edge = packet.task_edge;
+    flit.injection_timestamp = packet.injection_timestamp;
+    flit.packet_id = packet.packet_id;
 
     if (packet.size == packet.flit_left)
 	flit.flit_type = FLIT_TYPE_HEAD;
@@ -80,8 +215,8 @@ Flit ProcessingElement::nextFlit()
     else
 	flit.flit_type = FLIT_TYPE_BODY;
 
-    packet_queue.front().flit_left--;
-    if (packet_queue.front().flit_left == 0)
+    packet.flit_left--;
+    if (packet.flit_left == 0)
 	packet_queue.pop();
 
     return flit;
@@ -109,38 +244,29 @@ bool ProcessingElement::canShot(Packet & packet)
 	return false;
 #endif
     bool shot;
-    double threshold;
 
     double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
 
     if (GlobalParams::traffic_distribution != TRAFFIC_TABLE_BASED) {
-	if (!transmittedAtPreviousCycle)
-	    threshold = GlobalParams::packet_injection_rate;
-	else
-	    threshold = GlobalParams::probability_of_retransmission;
-
-	shot = (((double) rand()) / RAND_MAX < threshold);
+	shot = injectionShot();
 	if (shot) {
-	    if (GlobalParams::traffic_distribution == TRAFFIC_RANDOM)
+	    if (profile.traffic_distribution == TRAFFIC_RANDOM)
 		    packet = trafficRandom();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_TRANSPOSE1)
-		    packet = trafficTranspose1();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_TRANSPOSE2)
-    		packet = trafficTranspose2();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_BIT_REVERSAL)
-		    packet = trafficBitReversal();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_SHUFFLE)
-		    packet = trafficShuffle();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_BUTTERFLY)
-		    packet = trafficButterfly();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_LOCAL)
+        else if (profile.traffic_distribution == TRAFFIC_TRANSPOSE1 ||
+                 profile.traffic_distribution == TRAFFIC_TRANSPOSE2 ||
+                 profile.traffic_distribution == TRAFFIC_BIT_REVERSAL ||
+                 profile.traffic_distribution == TRAFFIC_SHUFFLE ||
+                 profile.traffic_distribution == TRAFFIC_BUTTERFLY)
+		    packet = trafficPermutation();
+        else if (profile.traffic_distribution == TRAFFIC_LOCAL)
 		    packet = trafficLocal();
-        else if (GlobalParams::traffic_distribution == TRAFFIC_ULOCAL)
+        else if (profile.traffic_distribution == TRAFFIC_ULOCAL)
 		    packet = trafficULocal();
         else {
-            cout << "Invalid traffic distribution: " << GlobalParams::traffic_distribution << endl;
+            cout << "Invalid traffic distribution: " << profile.traffic_distribution << endl;
             exit(-1);
         }
+	    packet.traffic_class = 0;
 	}
     } else {			// Table based communication traffic
 	if (never_transmit)
@@ -151,47 +277,390 @@ bool ProcessingElement::canShot(Packet & packet)
 	double threshold =
 	    traffic_table->getCumulativePirPor(local_id, (int) now, use_pir, dst_prob);
 
-	double prob = (double) rand() / RAND_MAX;
+	double prob = (double) nextRandom() / RAND_MAX;
 	shot = (prob < threshold);
 	if (shot) {
 	    for (unsigned int i = 0; i < dst_prob.size(); i++) {
 		if (prob < dst_prob[i].second) {
                     int vc = randInt(0,GlobalParams::n_virtual_channels-1);
 		    packet.make(local_id, dst_prob[i].first, vc, now, getRandomSize());
+		    packet.traffic_class = traffic_table->getTrafficClass(local_id, dst_prob[i].first);
 		    break;
 		}
 	    }
 	}
     }
 
+    // each QoS class only uses its own partition of the VCs
+    if (shot && GlobalParams::qos_classes > 1)
+	packet.vc_id = classVC(packet.traffic_class);
+
+    if (shot && GlobalParams::multicast_rate > 0 &&
+	((double) nextRandom()) / RAND_MAX < GlobalParams::multicast_rate)
+	makeMulticast(packet);
+
     return shot;
 }
 
+void ProcessingElement::resetInjection()
+{
+    // Bernoulli injections of the synthetic distributions (the ones
+    // going through canShot()) are pre-generated, the first one at the
+    // first cycle after the reset. Closed-loop requesters keep drawing
+    // injectionShot() every cycle
+    pregenerated_injection = (GlobalParams::traffic_distribution != TRAFFIC_TABLE_BASED &&
+			      GlobalParams::traffic_distribution != TRAFFIC_TRACE_REPLAY &&
+			      GlobalParams::traffic_distribution != TRAFFIC_CLOSED_LOOP &&
+			      GlobalParams::traffic_distribution != TRAFFIC_TASK_GRAPH &&
+			      profile.injection_process == INJECTION_BERNOULLI);
+    next_injection = NOT_VALID;
+
+    if (profile.injection_process == INJECTION_MMPP)
+    {
+	mmpp_state = randInt(0, GlobalParams::mmpp_state_rates.size() - 1);
+	mmpp_rate = mmppStateRate(mmpp_state, profile.packet_injection_rate);
+    }
+    else if (profile.injection_process == INJECTION_SELF_SIMILAR)
+    {
+	// sources start at random points of their periods
+	onoff_on.resize(GlobalParams::onoff_sources);
+	onoff_left.resize(GlobalParams::onoff_sources);
+	for (int s = 0; s < GlobalParams::onoff_sources; s++)
+	{
+	    onoff_on[s] = (nextRandom() % 2 == 0);
+	    onoff_left[s] = onoffPeriod() * nextRandom() / RAND_MAX;
+	}
+    }
+    else if (profile.injection_process == INJECTION_DMA)
+	dma_phase = nextRandom();
+}
 
-Packet ProcessingElement::trafficLocal()
+double ProcessingElement::onoffPeriod()
 {
-    Packet p;
-    p.src_id = local_id;
-    double rnd = rand() / (double) RAND_MAX;
+    // heavy tailed periods of shape 3 - 2H make the aggregated traffic
+    // self-similar with Hurst parameter H
+    double alpha = 3.0 - 2.0 * GlobalParams::hurst;
+    double x_min = GlobalParams::onoff_mean_period * (alpha - 1.0) / alpha;
+    double u = (nextRandom() + 1.0) / (RAND_MAX + 1.0);
+
+    return x_min / pow(u, 1.0 / alpha);
+}
+
+bool ProcessingElement::injectionDue()
+{
+    if (never_transmit)
+	return false;
+
+    if (!pregenerated_injection)
+	return true;
+
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    // as if nothing was injected in the cycle before the first one
+    if (next_injection < 0)
+	next_injection = now - 1 + injectionGap(profile.packet_injection_rate, profile.packet_injection_rate);
+
+    return now >= next_injection;
+}
+
+double ProcessingElement::injectionGap(const double first_probability, const double probability)
+{
+    // inverse transform: a shot with first_probability in the first
+    // cycle, then with probability in each of the following ones
+    // (geometric number of cycles)
+    double u = (nextRandom() + 1.0) / (RAND_MAX + 1.0);
+
+    if (u <= first_probability)
+	return 1.0;
 
-    vector<int> dst_set;
+    if (probability <= 0.0)
+	return HUGE_VAL;
 
-    int max_id = (GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y);
+    if (probability >= 1.0)
+	return 2.0;
 
-    for (int i=0;i<max_id;i++)
+    double v = (nextRandom() + 1.0) / (RAND_MAX + 1.0);
+
+    return 2.0 + floor(log(v) / log(1.0 - probability));
+}
+
+bool ProcessingElement::injectionShot()
+{
+    if (profile.injection_process == INJECTION_MMPP)
     {
-	if (rnd<=GlobalParams::locality)
+	// geometric sojourn, then a jump to any other state
+	int n_states = GlobalParams::mmpp_state_rates.size();
+	if (n_states > 1 && ((double) nextRandom()) / RAND_MAX < 1.0 / GlobalParams::mmpp_state_sojourn[mmpp_state])
 	{
-	    if (local_id!=i && sameRadioHub(local_id,i))
-		dst_set.push_back(i);
+	    mmpp_state = (mmpp_state + randInt(1, n_states - 1)) % n_states;
+	    mmpp_rate = mmppStateRate(mmpp_state, profile.packet_injection_rate);
 	}
-	else
-	    if (!sameRadioHub(local_id,i))
-		dst_set.push_back(i);
+
+	return ((double) nextRandom()) / RAND_MAX < mmpp_rate;
+    }
+
+    if (profile.injection_process == INJECTION_SELF_SIMILAR)
+    {
+	int on = 0;
+	for (int s = 0; s < GlobalParams::onoff_sources; s++)
+	{
+	    if (--onoff_left[s] <= 0)
+	    {
+		onoff_on[s] = !onoff_on[s];
+		onoff_left[s] += onoffPeriod();
+	    }
+	    if (onoff_on[s])
+		on++;
+	}
+
+	// sources are on half of the time on average
+	double threshold = 2.0 * profile.packet_injection_rate * on / GlobalParams::onoff_sources;
+	return ((double) nextRandom()) / RAND_MAX < threshold;
+    }
+
+    if (profile.injection_process == INJECTION_DMA)
+    {
+	if (profile.packet_injection_rate <= 0.0)
+	    return false;
+
+	// dma_burst back to back packets per period, for an average
+	// of packet_injection_rate
+	int period = max(GlobalParams::dma_burst,
+			 (int) (GlobalParams::dma_burst / profile.packet_injection_rate + 0.5));
+	int now = (int) (sc_time_stamp().to_double() / GlobalParams::clock_period_ps);
+
+	return (now % period + dma_phase % period) % period < GlobalParams::dma_burst;
     }
 
+    // INJECTION_BERNOULLI: called at the pre-generated cycle (or later,
+    // if a full queue stalled the source), which shoots and draws the
+    // next one. The cycle after a shot is retransmitted with
+    // probability_of_retransmission, the others with packet_injection_rate
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+    next_injection = now + injectionGap(profile.probability_of_retransmission, profile.packet_injection_rate);
+
+    return true;
+}
 
-    int i_rnd = rand()%dst_set.size();
+void ProcessingElement::replayTrace()
+{
+    if (never_transmit)
+	return;
+
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    // trace cycles are counted from the end of the reset
+    const TraceRecord * record;
+    while ((record = trace_replay->front(local_id)) != NULL &&
+	   record->cycle + GlobalParams::reset_time <= now)
+    {
+	// packets are injected in order, so one waiting for its
+	// dependency also holds the following ones
+	if (record->dep_id != TRACE_NO_DEPENDENCY && !trace_replay->isDelivered(record->dep_id))
+	    break;
+
+	// trace packets are never dropped: a full queue holds the trace
+	if (packet_queue.full())
+	{
+	    if (afterWarmUp())
+		stalled_cycles++;
+	    break;
+	}
+
+	int vc = classVC(0);	// class 0: its own partition of the VCs (QoS)
+	Packet packet(local_id, record->dst, vc, now, record->size);
+	packet.trace_id = record->id;
+
+	signPacket(packet);
+	packet_queue.push(packet);
+	trace_replay->pop(local_id);
+
+	if (afterWarmUp())
+	{
+	    offered_flits += packet.size;
+	    accepted_flits += packet.size;
+	}
+    }
+}
+
+// Every packet entering the source queue is signed, whatever the traffic:
+// the signatures of traffic depending on the network (trace dependencies,
+// closed-loop and task graph traffic) differ when the timing does
+void ProcessingElement::signPacket(const Packet & packet)
+{
+    // FNV-1a over the fields decided by the traffic stream
+    unsigned long long fields[4] = { (unsigned long long) packet.timestamp, (unsigned long long) packet.dst_id,
+				     (unsigned long long) packet.size, (unsigned long long) packet.vc_id };
+
+    for (int i = 0; i < 4; i++)
+    {
+	traffic_signature ^= fields[i];
+	traffic_signature *= 1099511628211ULL;
+    }
+}
+
+bool ProcessingElement::afterWarmUp() const
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    return now - GlobalParams::reset_time >= GlobalParams::stats_warm_up_time;
+}
+
+void ProcessingElement::closedLoopTx()
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    if (memory_controller)
+    {
+	// same service latency for all requests: replies are due in order
+	while (!served_replies.empty() && served_replies.front().timestamp <= now)
+	{
+	    Packet reply = served_replies.front();
+	    reply.timestamp = now;
+	    signPacket(reply);
+	    packet_queue.push(reply);
+	    served_replies.pop();
+	}
+	return;
+    }
+
+    // the injection process issues the requests, as long as a slot
+    // (MSHR) is free
+    bool shot = injectionShot();
+    if (outstanding >= GlobalParams::max_outstanding || !shot)
+	return;
+
+    int mc = GlobalParams::memory_controllers[randInt(0, GlobalParams::memory_controllers.size() - 1)];
+    int vc = classVC(0);	// class 0: its own partition of the VCs (QoS)
+    Packet request(local_id, mc, vc, now, getRandomSize());
+    request.transaction = TRANSACTION_REQUEST;
+
+    signPacket(request);
+    packet_queue.push(request);
+    outstanding++;
+}
+
+void ProcessingElement::transactionReceived(const Flit & tail)
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    if (tail.transaction == TRANSACTION_REQUEST)
+    {
+	assert(memory_controller);
+
+	int vc = classVC(0);	// class 0: its own partition of the VCs (QoS)
+	Packet reply(local_id, tail.src_id, vc, now + GlobalParams::service_latency, GlobalParams::reply_size);
+	reply.transaction = TRANSACTION_REPLY;
+	reply.request_timestamp = tail.request_timestamp;
+	served_replies.push(reply);
+	return;
+    }
+
+    outstanding--;
+
+    if (tail.request_timestamp - GlobalParams::reset_time < GlobalParams::stats_warm_up_time)
+	return;
+
+    double round_trip = now - tail.request_timestamp;
+    transactions++;
+    round_trip_sum += round_trip;
+    if (round_trip > round_trip_max)
+	round_trip_max = round_trip;
+}
+
+void ProcessingElement::taskGraphTx()
+{
+    double now = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+
+    if (running_task != NOT_VALID && now >= compute_end)
+    {
+	// the messages leave once the computation is over
+	Task & task = task_graph->getTask(running_task);
+	for (unsigned int i = 0; i < task.out_edges.size(); i++)
+	{
+	    int e = task.out_edges[i];
+	    TaskEdge & edge = task_graph->getEdge(e);
+	    int dst = task_graph->getTask(edge.dst).tile;
+
+	    for (int p = 0; p < edge.packets; p++)
+	    {
+		// tasks on the same tile do not use the network
+		if (dst == local_id)
+		{
+		    int ready = task_graph->packetDelivered(e);
+		    if (ready != NOT_VALID)
+			ready_tasks.push(ready);
+		    continue;
+		}
+
+		int size = edge.size / edge.packets + (p < edge.size % edge.packets ? 1 : 0);
+		int vc = classVC(0);	// class 0: its own partition of the VCs (QoS)
+		Packet packet(local_id, dst, vc, now, size);
+		packet.task_edge = e;
+		signPacket(packet);
+		packet_queue.push(packet);
+	    }
+	}
+
+	task_graph->taskCompleted(running_task, now - GlobalParams::reset_time);
+	running_task = NOT_VALID;
+
+	if (task_graph->allCompleted())
+	    sc_stop();
+    }
+
+    // the PE runs a task at a time, in the order they became ready
+    if (running_task == NOT_VALID && !ready_tasks.empty())
+    {
+	running_task = ready_tasks.front();
+	ready_tasks.pop();
+	compute_end = now + task_graph->getTask(running_task).compute_cycles;
+    }
+}
+
+void ProcessingElement::makeMulticast(Packet & packet)
+{
+    int n_nodes = GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y;
+
+    packet.dst_set.reset();
+
+    if (GlobalParams::multicast_size == 0)
+    {
+	// broadcast
+	for (int id = 0; id < n_nodes; id++)
+	    if (id != local_id)
+		packet.dst_set.set(id);
+    }
+    else
+	while ((int)packet.dst_set.count() < GlobalParams::multicast_size)
+	{
+	    int id = randInt(0, n_nodes - 1);
+	    if (id != local_id)
+		packet.dst_set.set(id);
+	}
+
+    // dst_id stays meaningful for the code looking at a single destination
+    packet.dst_id = firstDestination(packet.dst_set);
+}
+
+int ProcessingElement::classVC(const int traffic_class)
+{
+    int first = traffic_class * GlobalParams::n_virtual_channels / GlobalParams::qos_classes;
+    int last = (traffic_class + 1) * GlobalParams::n_virtual_channels / GlobalParams::qos_classes - 1;
+
+    return randInt(first, last);
+}
+
+
+Packet ProcessingElement::trafficLocal()
+{
+    Packet p;
+    p.src_id = local_id;
+    double rnd = nextRandom() / (double) RAND_MAX;
+
+    const vector<int> & dst_set = (rnd <= GlobalParams::locality) ? same_hub_dst : other_hub_dst;
+
+    int i_rnd = nextRandom()%dst_set.size();
 
     p.dst_id = dst_set[i_rnd];
     p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
@@ -206,8 +675,8 @@ int ProcessingElement::findRandomDestination(int id, int hops)
 {
     assert(GlobalParams::topology == TOPOLOGY_MESH);
 
-    int inc_y = rand()%2?-1:1;
-    int inc_x = rand()%2?-1:1;
+    int inc_y = nextRandom()%2?-1:1;
+    int inc_x = nextRandom()%2?-1:1;
     
     Coord current =  id2Coord(id);
     
@@ -228,7 +697,7 @@ int ProcessingElement::findRandomDestination(int id, int hops)
 	if (current.y==GlobalParams::mesh_dim_y-1)
 	    if (inc_y>0) inc_y=0;
 
-	if (rand()%2)
+	if (nextRandom()%2)
 	    current.x +=inc_x;
 	else
 	    current.y +=inc_y;
@@ -237,12 +706,12 @@ int ProcessingElement::findRandomDestination(int id, int hops)
 }
 
 
-int roulette()
+int ProcessingElement::roulette()
 {
     int slices = GlobalParams::mesh_dim_x + GlobalParams::mesh_dim_y -2;
 
 
-    double r = rand()/(double)RAND_MAX;
+    double r = nextRandom()/(double)RAND_MAX;
 
 
     for (int i=1;i<=slices;i++)
@@ -277,8 +746,7 @@ Packet ProcessingElement::trafficRandom()
 {
     Packet p;
     p.src_id = local_id;
-    double rnd = rand() / (double) RAND_MAX;
-    double range_start = 0.0;
+    double rnd = nextRandom() / (double) RAND_MAX;
     int max_id;
 
     if (GlobalParams::topology == TOPOLOGY_MESH)
@@ -286,21 +754,17 @@ Packet ProcessingElement::trafficRandom()
     else    // other delta topologies
 	max_id = GlobalParams::n_delta_tiles-1; 
 
+    // hotspot whose range contains rnd, if any. The retries below keep
+    // it (the ranges used to drift when a retry was needed)
+    size_t hotspot = upper_bound(hotspot_limits.begin(), hotspot_limits.end(), rnd) - hotspot_limits.begin();
+
     // Random destination distribution
     do {
 	p.dst_id = randInt(0, max_id);
 
 	// check for hotspot destination
-	for (size_t i = 0; i < GlobalParams::hotspots.size(); i++) {
-
-	    if (rnd >= range_start && rnd < range_start + GlobalParams::hotspots[i].second) {
-		if (local_id != GlobalParams::hotspots[i].first ) {
-		    p.dst_id = GlobalParams::hotspots[i].first;
-		}
-		break;
-	    } else
-		range_start += GlobalParams::hotspots[i].second;	// try next
-	}
+	if (hotspot < hotspot_limits.size() && local_id != GlobalParams::hotspots[hotspot].first)
+	    p.dst_id = GlobalParams::hotspots[hotspot].first;
 #ifdef DEADLOCK_AVOIDANCE
 	assert((GlobalParams::topology == TOPOLOGY_MESH));
 	if (p.dst_id%2!=0)
@@ -331,48 +795,47 @@ Packet ProcessingElement::trafficTest()
     return p;
 }
 
-Packet ProcessingElement::trafficTranspose1()
+Packet ProcessingElement::trafficPermutation()
 {
-    assert(GlobalParams::topology == TOPOLOGY_MESH);
     Packet p;
     p.src_id = local_id;
+    p.dst_id = permutation_dst;
+
+    p.vc_id = randInt(0,GlobalParams::n_virtual_channels-1);
+    p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
+    p.size = p.flit_left = getRandomSize();
+
+    return p;
+}
+
+int ProcessingElement::transpose1Destination()
+{
+    assert(GlobalParams::topology == TOPOLOGY_MESH);
     Coord src, dst;
 
     // Transpose 1 destination distribution
-    src.x = id2Coord(p.src_id).x;
-    src.y = id2Coord(p.src_id).y;
+    src.x = id2Coord(local_id).x;
+    src.y = id2Coord(local_id).y;
     dst.x = GlobalParams::mesh_dim_x - 1 - src.y;
     dst.y = GlobalParams::mesh_dim_y - 1 - src.x;
     fixRanges(src, dst);
-    p.dst_id = coord2Id(dst);
 
-    p.vc_id = randInt(0,GlobalParams::n_virtual_channels-1);
-    p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
-    p.size = p.flit_left = getRandomSize();
-
-    return p;
+    return coord2Id(dst);
 }
 
-Packet ProcessingElement::trafficTranspose2()
+int ProcessingElement::transpose2Destination()
 {
     assert(GlobalParams::topology == TOPOLOGY_MESH);
-    Packet p;
-    p.src_id = local_id;
     Coord src, dst;
 
     // Transpose 2 destination distribution
-    src.x = id2Coord(p.src_id).x;
-    src.y = id2Coord(p.src_id).y;
+    src.x = id2Coord(local_id).x;
+    src.y = id2Coord(local_id).y;
     dst.x = src.y;
     dst.y = src.x;
     fixRanges(src, dst);
-    p.dst_id = coord2Id(dst);
 
-    p.vc_id = randInt(0,GlobalParams::n_virtual_channels-1);
-    p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
-    p.size = p.flit_left = getRandomSize();
-
-    return p;
+    return coord2Id(dst);
 }
 
 void ProcessingElement::setBit(int &x, int w, int v)
@@ -397,7 +860,7 @@ inline double ProcessingElement::log2ceil(double x)
     return ceil(log(x) / log(2.0));
 }
 
-Packet ProcessingElement::trafficBitReversal()
+int ProcessingElement::bitReversalDestination()
 {
 
     int nbits =
@@ -409,18 +872,10 @@ Packet ProcessingElement::trafficBitReversal()
     for (int i = 0; i < nbits; i++)
 	setBit(dnode, i, getBit(local_id, nbits - i - 1));
 
-    Packet p;
-    p.src_id = local_id;
-    p.dst_id = dnode;
-
-    p.vc_id = randInt(0,GlobalParams::n_virtual_channels-1);
-    p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
-    p.size = p.flit_left = getRandomSize();
-
-    return p;
+    return dnode;
 }
 
-Packet ProcessingElement::trafficShuffle()
+int ProcessingElement::shuffleDestination()
 {
 
     int nbits =
@@ -433,18 +888,10 @@ Packet ProcessingElement::trafficShuffle()
 	setBit(dnode, i + 1, getBit(local_id, i));
     setBit(dnode, 0, getBit(local_id, nbits - 1));
 
-    Packet p;
-    p.src_id = local_id;
-    p.dst_id = dnode;
-
-    p.vc_id = randInt(0,GlobalParams::n_virtual_channels-1);
-    p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
-    p.size = p.flit_left = getRandomSize();
-
-    return p;
+    return dnode;
 }
 
-Packet ProcessingElement::trafficButterfly()
+int ProcessingElement::butterflyDestination()
 {
 
     int nbits = (int) log2ceil((double)
@@ -456,15 +903,46 @@ Packet ProcessingElement::trafficButterfly()
     setBit(dnode, 0, getBit(local_id, nbits - 1));
     setBit(dnode, nbits - 1, getBit(local_id, 0));
 
-    Packet p;
-    p.src_id = local_id;
-    p.dst_id = dnode;
+    return dnode;
+}
 
-    p.vc_id = randInt(0,GlobalParams::n_virtual_channels-1);
-    p.timestamp = sc_time_stamp().to_double() / GlobalParams::clock_period_ps;
-    p.size = p.flit_left = getRandomSize();
+void ProcessingElement::buildDestinations()
+{
+    string traffic = profile.traffic_distribution;
 
-    return p;
+    if (traffic == TRAFFIC_LOCAL)
+    {
+	for (int i = 0; i < GlobalParams::mesh_dim_x * GlobalParams::mesh_dim_y; i++)
+	{
+	    if (sameRadioHub(local_id, i))
+	    {
+		if (i != local_id)
+		    same_hub_dst.push_back(i);
+	    }
+	    else
+		other_hub_dst.push_back(i);
+	}
+    }
+
+    double limit = 0.0;
+    for (size_t i = 0; i < GlobalParams::hotspots.size(); i++)
+    {
+	limit += GlobalParams::hotspots[i].second;
+	hotspot_limits.push_back(limit);
+    }
+
+    if (traffic == TRAFFIC_TRANSPOSE1)
+	permutation_dst = transpose1Destination();
+    else if (traffic == TRAFFIC_TRANSPOSE2)
+	permutation_dst = transpose2Destination();
+    else if (traffic == TRAFFIC_BIT_REVERSAL)
+	permutation_dst = bitReversalDestination();
+    else if (traffic == TRAFFIC_SHUFFLE)
+	permutation_dst = shuffleDestination();
+    else if (traffic == TRAFFIC_BUTTERFLY)
+	permutation_dst = butterflyDestination();
+
+    destinations_built = true;
 }
 
 void ProcessingElement::fixRanges(const Coord src,
@@ -483,8 +961,23 @@ void ProcessingElement::fixRanges(const Coord src,
 
 int ProcessingElement::getRandomSize()
 {
-    return randInt(GlobalParams::min_packet_size,
-		   GlobalParams::max_packet_size);
+    if (profile.packet_sizes.empty())
+	return randInt(profile.min_packet_size, profile.max_packet_size);
+
+    // mix of sizes, e.g. bimodal control and data packets
+    double total = 0.0;
+    for (unsigned int i = 0; i < profile.packet_size_weights.size(); i++)
+	total += profile.packet_size_weights[i];
+
+    double rnd = nextRandom() / (RAND_MAX + 1.0) * total;
+    for (unsigned int i = 0; i < profile.packet_sizes.size() - 1; i++)
+    {
+	if (rnd < profile.packet_size_weights[i])
+	    return profile.packet_sizes[i];
+	rnd -= profile.packet_size_weights[i];
+    }
+
+    return profile.packet_sizes.back();
 }
 
 unsigned int ProcessingElement::getQueueSize() const
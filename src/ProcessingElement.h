@@ -16,6 +16,10 @@
 
 #include "DataStructs.h"
 #include "GlobalTrafficTable.h"
+#include "PacketQueue.h"
+#include "TraceReplay.h"
+#include "TaskGraph.h"
+#include "FlowControl.h"
 #include "Utils.h"
 
 using namespace std;
@@ -43,41 +47,102 @@ SC_MODULE(ProcessingElement)
     int local_id;		// Unique identification number
     bool current_level_rx;	// Current level for Alternating Bit Protocol (ABP)
     bool current_level_tx;	// Current level for Alternating Bit Protocol (ABP)
-    queue < Packet > packet_queue;	// Local queue of packets
+    LinkReceiver link_rx;	// Credits returned to the router (credit based flow control)
+    LinkSender link_tx;		// Credits of the router local input (credit based flow control)
+    PacketQueue packet_queue;	// Local (source) queue of packets
+    int injected_packets;	// Packets which entered the network, numbering the next one
+
+    // Source queue load, counted after the warm-up
+    unsigned long offered_flits;	// Flits generated by the traffic source
+    unsigned long accepted_flits;	// Flits entered in the source queue
+    unsigned long dropped_packets;	// Packets dropped, the queue being full (SOURCE_QUEUE_DROP)
+    unsigned long stalled_cycles;	// Cycles the source was stalled, the queue being full (SOURCE_QUEUE_STALL)
+    unsigned int max_queue_size;	// Largest occupancy of the source queue
     bool transmittedAtPreviousCycle;	// Used for distributions with memory
 
+    TrafficProfile profile;	// Traffic generated by the PE (synthetic distributions)
+    unsigned int rng_state;	// Random stream of the traffic generation
+    unsigned long long traffic_signature;	// Hash of the packets offered by the traffic source
+
+    // Injection processes
+    int mmpp_state;		// Current state of the MMPP
+    double mmpp_rate;		// Injection probability in mmpp_state
+    vector < bool > onoff_on;	// State of each Pareto on/off source (SELF_SIMILAR)
+    vector < double > onoff_left;	// Cycles left in the current period of each source
+    int dma_phase;		// Position of the PE bursts within the DMA period
+    bool pregenerated_injection;	// Bernoulli injection cycles drawn in advance
+    double next_injection;	// Cycle of the next Bernoulli injection (NOT_VALID: not drawn yet)
+
+    // Closed-loop traffic
+    bool memory_controller;	// true if the PE answers requests instead of issuing them
+    int outstanding;		// Requests waiting for their reply
+    queue < Packet > served_replies;	// Replies due after the service latency, in order
+    unsigned long transactions;	// Replies received for requests issued after the warm-up
+    double round_trip_sum;	// Round-trip latencies of those transactions [cycles]
+    double round_trip_max;
+
     // Functions
     void rxProcess();		// The receiving process
     void txProcess();		// The transmitting process
     bool canShot(Packet & packet);	// True when the packet must be shot
+    bool injectionShot();	// True when the injection process shoots in this cycle
+    bool injectionDue();	// False while the PE waits for its pre-generated injection
+    double injectionGap(const double first_probability, const double probability);	// Cycles to the next Bernoulli injection
+    void resetInjection();	// Initial state of the injection process
+    double onoffPeriod();	// Pareto distributed length of an ON or OFF period
     Flit nextFlit();	// Take the next flit of the current packet
     Packet trafficTest();	// used for testing traffic
     Packet trafficRandom();	// Random destination distribution
-    Packet trafficTranspose1();	// Transpose 1 destination distribution
-    Packet trafficTranspose2();	// Transpose 2 destination distribution
-    Packet trafficBitReversal();	// Bit-reversal destination distribution
-    Packet trafficShuffle();	// Shuffle destination distribution
-    Packet trafficButterfly();	// Butterfly destination distribution
+    Packet trafficPermutation();	// Fixed destination of the permutation distributions
+    int transpose1Destination();	// Transpose 1 destination distribution
+    int transpose2Destination();	// Transpose 2 destination distribution
+    int bitReversalDestination();	// Bit-reversal destination distribution
+    int shuffleDestination();	// Shuffle destination distribution
+    int butterflyDestination();	// Butterfly destination distribution
     Packet trafficLocal();	// Random with locality
     Packet trafficULocal();	// Random with locality
+    void replayTrace();		// Queues the trace packets due in this cycle
+    void closedLoopTx();	// Issues requests, or the replies served (closed-loop traffic)
+    void transactionReceived(const Flit & tail);	// Tail of a request or reply received
+    void taskGraphTx();		// Runs the ready tasks and sends their messages
+    bool afterWarmUp() const;	// True when the source queue statistics are collected
+    void signPacket(const Packet & packet);	// Adds an offered packet to traffic_signature
+
+    // Destinations precomputed once, at reset
+    bool destinations_built;
+    vector < int > same_hub_dst;	// Nodes attached to the radio hub of the PE (TRAFFIC_LOCAL)
+    vector < int > other_hub_dst;	// Nodes attached to the other hubs (TRAFFIC_LOCAL)
+    vector < double > hotspot_limits;	// Cumulative hotspot percentages
+    int permutation_dst;		// Destination of the permutation distributions
+    void buildDestinations();
 
     GlobalTrafficTable *traffic_table;	// Reference to the Global traffic Table
+    TraceReplay *trace_replay;	// Reference to the replayed trace
+    TaskGraph *task_graph;	// Reference to the application task graph
+    queue < int > ready_tasks;	// Tasks of the tile whose messages all arrived
+    int running_task;		// Task being computed, NOT_VALID if none
+    double compute_end;		// Cycle at which running_task ends its computation
     bool never_transmit;	// true if the PE does not transmit any packet 
     //  (valid only for the table based traffic)
 
     void fixRanges(const Coord, Coord &);	// Fix the ranges of the destination
+    int nextRandom();		// Next number of the traffic stream, in [0, RAND_MAX]
     int randInt(int min, int max);	// Extracts a random integer number between min and max
     int getRandomSize();	// Returns a random size in flits for the packet
+    int classVC(const int traffic_class);	// Random VC among the ones reserved to traffic_class
+    void makeMulticast(Packet & packet);	// Turns packet into a multicast (multicast_rate)
     void setBit(int &x, int w, int v);
     int getBit(int x, int w);
     double log2ceil(double x);
 
-    int roulett();
+    int roulette();
     int findRandomDestination(int local_id,int hops);
     unsigned int getQueueSize() const;
 
     // Constructor
     SC_CTOR(ProcessingElement) {
+	destinations_built = false;
+
 	SC_METHOD(rxProcess);
 	sensitive << reset;
 	sensitive << clock.pos();
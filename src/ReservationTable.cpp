@@ -32,6 +32,17 @@ bool ReservationTable::isNotReserved(const int port_out)
     return (rtable[port_out].reservations.size()==0);
 }
 
+bool ReservationTable::isNotReserved(const int port_out, const int vc)
+{
+    assert(port_out<n_outputs);
+
+    for (vector<TReservation>::size_type i=0;i<rtable[port_out].reservations.size(); i++)
+	if (rtable[port_out].reservations[i].out_vc == vc)
+	    return false;
+
+    return true;
+}
+
 /* For a given input, returns the set of output/vc reserved from that input.
  * An index is required for each output entry, to avoid that multiple invokations
  * with different inputs returns the same output in the same clock cycle. */
@@ -51,11 +62,38 @@ vector<pair<int,int> > ReservationTable::getReservations(const int port_in)
     return reservations;
 }
 
-int ReservationTable::checkReservation(const TReservation r, const int port_out)
+int ReservationTable::getReservedOutput(TReservation & r)
+{
+    for (int o = 0; o < n_outputs; o++)
+	for (vector<TReservation>::size_type i = 0; i < rtable[o].reservations.size(); i++)
+	    if (rtable[o].reservations[i] == r)
+	    {
+		r.out_vc = rtable[o].reservations[i].out_vc;
+		return o;
+	    }
+
+    return NOT_VALID;
+}
+
+vector<TReservation> ReservationTable::getReservationsTo(const int port_out)
+{
+    assert(port_out<n_outputs);
+
+    vector<TReservation> reservations;
+    int n_reservations = rtable[port_out].reservations.size();
+
+    for (int i=0;i<n_reservations;i++)
+	reservations.push_back(rtable[port_out].reservations[(rtable[port_out].index+i)%n_reservations]);
+
+    return reservations;
+}
+
+int ReservationTable::checkReservation(const TReservation r, const int port_out, const bool multicast)
 {
     /* Sanity Check for forbidden table status:
-     * - same input/VC in a different output line */
-    for (int o=0;o<n_outputs;o++)
+     * - same input/VC in a different output line, unless the packet
+     *   is replicated on several outputs */
+    for (int o=0;o<n_outputs && !multicast;o++)
     {
 	for (vector<TReservation>::size_type i=0;i<rtable[o].reservations.size(); i++)
 	{
@@ -79,7 +117,7 @@ int ReservationTable::checkReservation(const TReservation r, const int port_out)
 
 	// the same VC for that output has been reserved by another input
 	if (rtable[port_out].reservations[i].input != r.input &&
-	    rtable[port_out].reservations[i].vc == r.vc)
+	    rtable[port_out].reservations[i].out_vc == r.out_vc)
 	    return RT_OUTVC_BUSY;
     }
     return RT_AVAILABLE;
@@ -100,13 +138,13 @@ void ReservationTable::print()
 }
 
 
-void ReservationTable::reserve(const TReservation r, const int port_out)
+void ReservationTable::reserve(const TReservation r, const int port_out, const bool multicast)
 {
     // IMPORTANT: problem when used by Hub with more connections
     //
     // reservation of reserved/not valid ports is illegal. Correctness
     // should be assured by ReservationTable users
-    assert(checkReservation(r, port_out)==RT_AVAILABLE);
+    assert(checkReservation(r, port_out, multicast)==RT_AVAILABLE);
 
     // TODO: a better policy could insert in a specific position as far a possible
     // from the current index
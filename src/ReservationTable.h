@@ -22,6 +22,7 @@ struct TReservation
 {
     int input;
     int vc;
+    int out_vc;	// VC allocated on the output (equal to vc unless the routing reallocates VCs)
     inline bool operator ==(const TReservation & r) const
     {
 	return (r.input==input && r.vc == vc);
@@ -42,10 +43,11 @@ class ReservationTable {
     inline string name() const {return "ReservationTable";};
 
     // check if the input/vc/output is a
-    int checkReservation(const TReservation r, const int port_out);
+    // A multicast input/VC may hold several outputs at the same time
+    int checkReservation(const TReservation r, const int port_out, const bool multicast = false);
 
     // Connects port_in with port_out. Asserts if port_out is reserved
-    void reserve(const TReservation r, const int port_out);
+    void reserve(const TReservation r, const int port_out, const bool multicast = false);
 
     // Releases port_out connection. 
     // Asserts if port_out is not reserved or not valid
@@ -54,12 +56,23 @@ class ReservationTable {
     // Returns the pairs of output port and virtual channel reserved by port_in
     vector<pair<int,int> > getReservations(const int port_int);
 
+    // Returns the output reserved by the input/VC of r, or NOT_VALID,
+    // and sets r.out_vc to the VC allocated on it
+    int getReservedOutput(TReservation & r);
+
+    // Returns the input/VC pairs which reserved port_out, starting from
+    // the one having the highest priority in the current cycle
+    vector<TReservation> getReservationsTo(const int port_out);
+
     // update the index of the reservation having highest priority in the current cycle
     void updateIndex();
 
     // check whether port_out has no reservations
     bool isNotReserved(const int port_out);
 
+    // check whether output virtual channel vc of port_out has no reservations
+    bool isNotReserved(const int port_out, const int vc);
+
     void setSize(const int n_outputs);
 
     void print();
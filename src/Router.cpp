@@ -9,6 +9,10 @@
  */
 
 #include "Router.h"
+#include "Hub.h"
+
+// Cycles spent by a flit on each wired hop (link + input buffer + switch)
+#define WIRED_HOP_CYCLES 2
 
 
 inline int toggleKthBit(int n, int k)
@@ -31,10 +35,22 @@ void Router::rxProcess()
 	    ack_rx[i].write(0);
 	    current_level_rx[i] = 0;
 	    buffer_full_status_rx[i].write(bfs);
+	    link_rx[i].reset();
 	}
 	routed_flits = 0;
+	bypassed_flits = 0;
 	local_drained = 0;
+
+	power_state = ROUTER_ON;
+	idle_cycles = 0;
+	wakeup_countdown = 0;
+	wakeup_requested = false;
+	gated_cycles = 0;
+	gating_events = 0;
+	gating_saved_energy = 0.0;
     } 
+    else if (power_state != ROUTER_ON)
+	gatedRx();
     else 
     { 
 	// This process simply sees a flow of incoming flits. All arbitration
@@ -46,6 +62,9 @@ void Router::rxProcess()
 	    // 2) there is a free slot in the input buffer of direction i
 	    //LOG<<"****RX****DIRECTION ="<<i<<  endl;
 
+	    if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+		creditRx(i);
+	    else
 	    if (req_rx[i].read() == 1 - current_level_rx[i])
 	    { 
 		Flit received_flit = flit_rx[i].read();
@@ -53,7 +72,14 @@ void Router::rxProcess()
 
 		int vc = received_flit.vc_id;
 
-		if (!buffer[i][vc].IsFull()) 
+		if (GlobalParams::router_bypass && bypass(i, received_flit))
+		{
+		    current_level_rx[i] = 1 - current_level_rx[i];
+
+		    if (received_flit.src_id == local_id)
+			power.networkInterface();
+		}
+		else if (!buffer[i][vc].IsFull()) 
 		{
 
 		    // Store the incoming flit in the circular buffer
@@ -85,11 +111,58 @@ void Router::rxProcess()
 	    TBufferFullStatus bfs;
 	    for (int vc=0;vc<GlobalParams::n_virtual_channels;vc++)
 		bfs.mask[vc] = buffer[i][vc].IsFull();
+	    link_rx[i].writeCredit(bfs);
 	    buffer_full_status_rx[i].write(bfs);
 	}
     }
 }
 
+void Router::creditRx(const int i)
+{
+    // the sender only transmits with credits, i.e. when a slot is
+    // guaranteed at the end of the link, so a flit can be sampled every
+    // cycle
+    if (req_rx[i].read() == 1 - current_level_rx[i])
+    {
+	link_rx[i].receive(flit_rx[i].read());
+	current_level_rx[i] = 1 - current_level_rx[i];
+    }
+
+    while (link_rx[i].flitArrived())
+    {
+	Flit received_flit = link_rx[i].popFlit();
+	int vc = received_flit.vc_id;
+
+	if (GlobalParams::router_bypass && bypass(i, received_flit))
+	{
+	    // the slot reserved by the sender is freed at once
+	    link_rx[i].returnCredit(vc);
+
+	    if (received_flit.src_id == local_id)
+		power.networkInterface();
+	    continue;
+	}
+
+	assert(!buffer[i][vc].IsFull());
+	buffer[i][vc].Push(received_flit);
+	LOG << " Flit " << received_flit << " collected from Input[" << i << "][" << vc <<"]" << endl;
+
+	power.bufferRouterPush();
+
+	if (received_flit.src_id == local_id)
+	    power.networkInterface();
+    }
+}
+
+bool Router::outputReady(const int o, const int vc)
+{
+    if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+	return link_tx[o].hasCredit(vc);
+
+    return (current_level_tx[o] == ack_tx[o].read()) &&
+	(buffer_full_status_tx[o].read().mask[vc] == false);
+}
+
 void Router::txProcess()
 {
 
@@ -100,10 +173,40 @@ void Router::txProcess()
 	{
 	  req_tx[i].write(0);
 	  current_level_tx[i] = 0;
+	  output_driven[i] = false;
+	}
+
+      // credits start from the slots of the downstream input ports
+      for (int o = 0; o < DIRECTIONS + 2; o++)
+	{
+	  BufferPool downstream = routerInputPool();
+	  if (o == DIRECTION_HUB)
+	      downstream.configure((hub != NULL) ? GlobalParams::hub_configuration[hub->local_id].fromTileBufferSize : 0, 0);
+	  link_tx[o].reset(downstream);
 	}
+
+      for (int i = 0; i < DIRECTIONS + 2; i++)
+	  for (int vc = 0; vc < MAX_VIRTUAL_CHANNELS; vc++)
+	  {
+	      multicast_branches[i][vc].clear();
+	      multicast_sent[i][vc] = 0;
+	  }
     } 
   else 
     { 
+      for (int o = 0; o < DIRECTIONS + 2; o++)
+	  output_driven[o] = false;
+
+      if (GlobalParams::router_architecture == ROUTER_DEFLECTION)
+      {
+	  deflectionTx();
+	  return;
+      }
+
+      if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+	  for (int o = 0; o < DIRECTIONS + 2; o++)
+	      link_tx[o].update(buffer_full_status_tx[o].read());
+
       // 1st phase: Reservation
       for (int j = 0; j < DIRECTIONS + 2; j++) 
 	{
@@ -132,9 +235,64 @@ void Router::txProcess()
 		      route_data.dst_id = flit.dst_id;
 		      route_data.dir_in = i;
 		      route_data.vc_id = flit.vc_id;
+		      route_data.packet_size = flit.sequence_length;
+
+		      TReservation r;
+		      r.input = i;
+		      r.vc = vc;
+		      r.out_vc = vc;
+
+		      // multicast: one reservation per branch of the tree. The
+		      // branches are reserved all at once, so that two packets
+		      // never hold a branch the other one is waiting for
+		      if (flit.dst_set.any())
+		      {
+			  if (multicast_branches[i][vc].empty())
+			      multicast_branches[i][vc] = multicastRoute(i, flit);
+
+			  bool all_available = true;
+			  for (map < int, DestinationSet >::iterator b = multicast_branches[i][vc].begin();
+			       b != multicast_branches[i][vc].end() && all_available; b++)
+			  {
+			      int rt_status = reservation_table.checkReservation(r, b->first, true);
+			      all_available = (rt_status == RT_AVAILABLE || rt_status == RT_ALREADY_SAME);
+			  }
+
+			  if (!all_available)
+			  {
+			      LOG << " multicast branches of flit " << flit << " not all available" << endl;
+			      continue;
+			  }
+
+			  for (map < int, DestinationSet >::iterator b = multicast_branches[i][vc].begin();
+			       b != multicast_branches[i][vc].end(); b++)
+			      if (reservation_table.checkReservation(r, b->first, true) == RT_AVAILABLE)
+			      {
+				  LOG << " reserving multicast branch " << b->first << " for flit " << flit << endl;
+				  reservation_table.reserve(r, b->first, true);
+			      }
+			  continue;
+		      }
 
 		      // TODO: see PER POSTERI (adaptive routing should not recompute route if already reserved)
-		      int o = route(route_data);
+		      int o;
+		      if (GlobalParams::routing_algorithm == ROUTING_FULLY_ADAPTIVE)
+		      {
+			  // output and output VC are allocated once per packet
+			  if (reservation_table.getReservedOutput(r) != NOT_VALID)
+			      continue;
+
+			  o = adaptiveRoute(route_data, r);
+			  if (o == NOT_VALID)
+			  {
+			      LOG << " no free output VC for flit " << flit << endl;
+			      continue;
+			  }
+		      }
+		      else if (GlobalParams::lookahead_routing && flit.lookahead_out != NOT_VALID)
+			  o = flit.lookahead_out;
+		      else
+			  o = route(route_data);
 
 		      // manage special case of target hub not directly connected to destination
 		      if (o>=DIRECTION_HUB_RELAY)
@@ -145,10 +303,6 @@ void Router::txProcess()
 		      	o = DIRECTION_HUB;
 			  }
 
-		      TReservation r;
-		      r.input = i;
-		      r.vc = vc;
-
 		      LOG << " checking availability of Output[" << o << "] for Input[" << i << "][" << vc << "] flit " << flit << endl;
 
 		      int rt_status = reservation_table.checkReservation(r,o);
@@ -181,96 +335,447 @@ void Router::txProcess()
 
       // 2nd phase: Forwarding
       //if (local_id==6) LOG<<"*TX*****local_id="<<local_id<<"__ack_tx[0]= "<<ack_tx[0].read()<<endl;
-      for (int i = 0; i < DIRECTIONS + 2; i++) 
+      vector<AllocRequest> grants = allocator->allocate(allocator_state, allocationRequests());
+
+      for (unsigned int g = 0; g < grants.size(); g++) 
       { 
-	  vector<pair<int,int> > reservations = reservation_table.getReservations(i);
-	  
-	  if (reservations.size()!=0)
+	  int i = grants[g].input;
+	  int o = grants[g].output;
+	  int vc = grants[g].vc;
+	  int out_vc = grants[g].out_vc;
+	 // LOG<< "found reservation from input= " << i << "_to output= "<<o<<endl;
+	  // can happen
+	  if (!buffer[i][vc].IsEmpty())  
 	  {
-
-	      int rnd_idx = rand()%reservations.size();
-
-	      int o = reservations[rnd_idx].first;
-	      int vc = reservations[rnd_idx].second;
-	     // LOG<< "found reservation from input= " << i << "_to output= "<<o<<endl;
-	      // can happen
-	      if (!buffer[i][vc].IsEmpty())  
-	      {
-		  // power contribution already computed in 1st phase
-		  Flit flit = buffer[i][vc].Front();
-		  //LOG<< "*****TX***Direction= "<<i<< "************"<<endl;
-		  //LOG<<"_cl_tx="<<current_level_tx[o]<<"req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<< endl;
+	      // power contribution already computed in 1st phase
+	      Flit flit = buffer[i][vc].Front();
+	      //LOG<< "*****TX***Direction= "<<i<< "************"<<endl;
+	      //LOG<<"_cl_tx="<<current_level_tx[o]<<"req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<< endl;
 		  
-		  if ( (current_level_tx[o] == ack_tx[o].read()) &&
-		       (buffer_full_status_tx[o].read().mask[vc] == false) ) 
-		  {
-		      //if (GlobalParams::verbose_mode > VERBOSE_OFF) 
-		      LOG << "Input[" << i << "][" << vc << "] forwarded to Output[" << o << "], flit: " << flit << endl;
+	      if (outputReady(o, out_vc)) 
+	      {
+		  //if (GlobalParams::verbose_mode > VERBOSE_OFF) 
+		  LOG << "Input[" << i << "][" << vc << "] forwarded to Output[" << o << "], flit: " << flit << endl;
 
-		      flit_tx[o].write(flit);
-		      current_level_tx[o] = 1 - current_level_tx[o];
-		      req_tx[o].write(current_level_tx[o]);
+		  if (!multicast_branches[i][vc].empty())
+		      forwardMulticast(i, vc, o, out_vc, flit);
+		  else
+		  {
 		      buffer[i][vc].Pop();
-
-		      if (flit.flit_type == FLIT_TYPE_TAIL)
-		      {
-			  TReservation r;
-			  r.input = i;
-			  r.vc = vc;
-			  reservation_table.release(r,o);
-		      }
-
-		      /* Power & Stats ------------------------------------------------- */
-		      if (o == DIRECTION_HUB) power.r2hLink();
-		      else
-			  power.r2rLink();
-
 		      power.bufferRouterPop();
-		      power.crossBar();
 
-		      if (o == DIRECTION_LOCAL) 
-		      {
-			  power.networkInterface();
-			  LOG << "Consumed flit " << flit << endl;
-			  stats.receivedFlit(sc_time_stamp().to_double() / GlobalParams::clock_period_ps, flit);
-			  if (GlobalParams:: max_volume_to_be_drained) 
-			  {
-			      if (drained_volume >= GlobalParams:: max_volume_to_be_drained)
-				  sc_stop();
-			      else 
-			      {
-				  drained_volume++;
-				  local_drained++;
-			      }
-			  }
-		      } 
-		      else if (i != DIRECTION_LOCAL) // not generated locally
-			  routed_flits++;
-		      /* End Power & Stats ------------------------------------------------- */
-			 //LOG<<"END_OK_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<< endl;
-		  }
-		  else
-		  {
-		      LOG << " Cannot forward Input[" << i << "][" << vc << "] to Output[" << o << "], flit: " << flit << endl;
-		      //LOG << " **DEBUG APB: current_level_tx: " << current_level_tx[o] << " ack_tx: " << ack_tx[o].read() << endl;
-		      LOG << " **DEBUG buffer_full_status_tx " << buffer_full_status_tx[o].read().mask[vc] << endl;
-
-		  	//LOG<<"END_NO_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<< endl;
-		      /*
-		      if (flit.flit_type == FLIT_TYPE_HEAD)
-			  reservation_table.release(i,flit.vc_id,o);
-			  */
+		      if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+			  link_rx[i].returnCredit(vc);
+
+		      forwardFlit(i, vc, o, out_vc, flit);
 		  }
+		     //LOG<<"END_OK_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<< endl;
+	      }
+	      else
+	      {
+		  LOG << " Cannot forward Input[" << i << "][" << vc << "] to Output[" << o << "], flit: " << flit << endl;
+		  //LOG << " **DEBUG APB: current_level_tx: " << current_level_tx[o] << " ack_tx: " << ack_tx[o].read() << endl;
+		  LOG << " **DEBUG buffer_full_status_tx " << buffer_full_status_tx[o].read().mask[out_vc] << endl;
+
+		    //LOG<<"END_NO_cl_tx="<<current_level_tx[o]<<"_req_tx="<<req_tx[o].read()<<" _ack= "<<ack_tx[o].read()<< endl;
+		  /*
+		  if (flit.flit_type == FLIT_TYPE_HEAD)
+		      reservation_table.release(i,flit.vc_id,o);
+		      */
 	      }
-	  } // if not reserved 
-	 // else LOG<<"we have no reservation for direction "<<i<< endl;
-      } // for loop directions
+	  }
+      } // for loop grants
+
+      // lookahead wake-up: the neighbors which will receive the packets
+      // crossing this router are powered on while the flits get here
+      if (GlobalParams::router_power_gating)
+	  for (int o = 0; o < DIRECTIONS; o++)
+	      if (neighbor[o] != NULL && !reservation_table.isNotReserved(o))
+		  neighbor[o]->wakeUp();
 
       if ((int)(sc_time_stamp().to_double() / GlobalParams::clock_period_ps)%2==0)
 	  reservation_table.updateIndex();
     }   
 }
 
+void Router::forwardFlit(const int i, const int vc, const int o, const int out_vc, Flit flit)
+{
+    flit.vc_id = out_vc;
+
+    if (GlobalParams::lookahead_routing && flit.flit_type == FLIT_TYPE_HEAD)
+	flit.lookahead_out = lookaheadRoute(o, flit);
+
+    flit_tx[o].write(flit);
+    current_level_tx[o] = 1 - current_level_tx[o];
+    req_tx[o].write(current_level_tx[o]);
+    output_driven[o] = true;
+
+    if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+	link_tx[o].consumeCredit(out_vc);
+
+    if (flit.flit_type == FLIT_TYPE_TAIL && GlobalParams::router_architecture == ROUTER_BUFFERED)
+    {
+	TReservation r;
+	r.input = i;
+	r.vc = vc;
+	reservation_table.release(r,o);
+    }
+
+    /* Power & Stats ------------------------------------------------- */
+    if (o == DIRECTION_HUB) power.r2hLink();
+    else
+	power.r2rLink();
+
+    power.crossBar();
+
+    if (o == DIRECTION_LOCAL) 
+    {
+	power.networkInterface();
+	LOG << "Consumed flit " << flit << endl;
+	stats.receivedFlit(sc_time_stamp().to_double() / GlobalParams::clock_period_ps, flit);
+	if (GlobalParams:: max_volume_to_be_drained) 
+	{
+	    if (drained_volume >= GlobalParams:: max_volume_to_be_drained)
+		sc_stop();
+	    else 
+	    {
+		drained_volume++;
+		local_drained++;
+	    }
+	}
+    } 
+    else if (i != DIRECTION_LOCAL) // not generated locally
+	routed_flits++;
+    /* End Power & Stats ------------------------------------------------- */
+}
+
+void Router::forwardMulticast(const int i, const int vc, const int o, const int out_vc, Flit flit)
+{
+    // each branch carries its own share of the destinations
+    flit.dst_set = multicast_branches[i][vc][o];
+    flit.dst_id = (o == DIRECTION_LOCAL) ? local_id : firstDestination(flit.dst_set);
+
+    multicast_sent[i][vc] |= 1 << o;
+
+    int all_branches = 0;
+    for (map < int, DestinationSet >::iterator b = multicast_branches[i][vc].begin();
+	 b != multicast_branches[i][vc].end(); b++)
+	all_branches |= 1 << b->first;
+
+    if (multicast_sent[i][vc] == all_branches)
+    {
+	buffer[i][vc].Pop();
+	power.bufferRouterPop();
+
+	if (GlobalParams::flow_control == FLOW_CONTROL_CREDIT)
+	    link_rx[i].returnCredit(vc);
+
+	multicast_sent[i][vc] = 0;
+	if (flit.flit_type == FLIT_TYPE_TAIL)
+	    multicast_branches[i][vc].clear();
+    }
+
+    forwardFlit(i, vc, o, out_vc, flit);
+}
+
+map < int, DestinationSet > Router::multicastRoute(const int i, const Flit & flit)
+{
+    map < int, DestinationSet > branches;
+
+    power.routing();
+
+    for (int dst = 0; dst < MAX_MULTICAST_NODES; dst++)
+    {
+	if (!flit.dst_set[dst])
+	    continue;
+
+	int o;
+
+	if (dst == local_id)
+	    o = DIRECTION_LOCAL;
+	else
+	{
+	    RouteData route_data;
+	    route_data.current_id = local_id;
+	    route_data.src_id = flit.src_id;
+	    route_data.dst_id = dst;
+	    route_data.dir_in = i;
+	    route_data.vc_id = flit.vc_id;
+	    route_data.packet_size = flit.sequence_length;
+
+	    o = routingFunction(route_data)[0];
+
+	    // only the source uses the radio, with a single transmission
+	    // heard by every destination hub; the rest follows the wires
+	    if (o >= DIRECTION_HUB &&
+		!(o == DIRECTION_HUB && i == DIRECTION_LOCAL && multicastOverRadio(dst)))
+		o = routingAlgorithm->route(this, route_data)[0];
+	}
+
+	branches[o].set(dst);
+    }
+
+    return branches;
+}
+
+bool Router::multicastOverRadio(const int dst) const
+{
+    if (!hasRadioHub(local_id) || !hasRadioHub(dst) || sameRadioHub(local_id, dst))
+	return false;
+
+    vector<int> & tx = GlobalParams::hub_configuration[tile2Hub(local_id)].txChannels;
+    vector<int> & rx = GlobalParams::hub_configuration[tile2Hub(dst)].rxChannels;
+
+    for (unsigned int k = 0; k < tx.size(); k++)
+	if (find(rx.begin(), rx.end(), tx[k]) == rx.end())
+	    return false;
+
+    return !tx.empty();
+}
+
+int Router::freeOutputVC(const int o, const int first_vc, const int last_vc)
+{
+    for (int vc = first_vc; vc <= last_vc; vc++)
+	if (reservation_table.isNotReserved(o, vc))
+	    return vc;
+
+    return NOT_VALID;
+}
+
+int Router::adaptiveRoute(const RouteData & route_data, TReservation & r)
+{
+    if (route_data.dst_id == local_id)
+	return DIRECTION_LOCAL;
+
+    power.routing();
+    vector < int > candidate_channels = routingFunction(route_data);
+
+    // wireless paths keep the VC of the packet
+    if (candidate_channels.size() == 1 && candidate_channels[0] >= DIRECTION_HUB)
+	return candidate_channels[0];
+
+    // adaptive VCs (1..n-1) can be taken towards any minimal direction
+    vector < int > free_channels;
+    for (unsigned int k = 0; k < candidate_channels.size(); k++)
+	if (freeOutputVC(candidate_channels[k], 1, GlobalParams::n_virtual_channels - 1) != NOT_VALID)
+	    free_channels.push_back(candidate_channels[k]);
+
+    if (!free_channels.empty())
+    {
+	power.selection();
+	int o = selectionFunction(free_channels, route_data);
+	r.out_vc = freeOutputVC(o, 1, GlobalParams::n_virtual_channels - 1);
+	return o;
+    }
+
+    // escape VC 0, only along the deadlock-free escape routing
+    vector < int > escape_channels = escapeRouting->route(this, route_data);
+    for (unsigned int k = 0; k < escape_channels.size(); k++)
+	if (freeOutputVC(escape_channels[k], 0, 0) != NOT_VALID)
+	{
+	    r.out_vc = 0;
+	    return escape_channels[k];
+	}
+
+    return NOT_VALID;
+}
+
+int Router::lookaheadRoute(const int o, const Flit & flit)
+{
+    // the route can be anticipated only towards a neighbor router
+    if (o >= DIRECTIONS || neighbor[o] == NULL)
+	return NOT_VALID;
+
+    RouteData route_data;
+    route_data.current_id = neighbor[o]->local_id;
+    route_data.src_id = flit.src_id;
+    route_data.dst_id = flit.dst_id;
+    route_data.dir_in = reflexDirection(o);
+    route_data.vc_id = flit.vc_id;
+    route_data.packet_size = flit.sequence_length;
+
+    return neighbor[o]->route(route_data);
+}
+
+bool Router::bypass(const int i, Flit flit)
+{
+    int vc = flit.vc_id;
+
+    // flits already waiting on the same input/VC must leave first
+    if (!buffer[i][vc].IsEmpty())
+	return false;
+
+    TReservation r;
+    r.input = i;
+    r.vc = vc;
+    r.out_vc = vc;
+
+    int o = NOT_VALID;
+
+    if (flit.flit_type == FLIT_TYPE_HEAD)
+    {
+	// a head flit can only skip the buffer if its route is already known
+	if (flit.dst_id == local_id)
+	    o = DIRECTION_LOCAL;
+	else if (GlobalParams::lookahead_routing)
+	    o = flit.lookahead_out;
+
+	if (o == NOT_VALID)
+	    return false;
+
+	if (o >= DIRECTION_HUB_RELAY)
+	{
+	    flit.hub_relay_node = o - DIRECTION_HUB_RELAY;
+	    o = DIRECTION_HUB;
+	}
+
+	// the output may have been driven by txProcess() in this cycle:
+	// with credits outputReady() does not see it
+	if (output_driven[o] || reservation_table.checkReservation(r, o) != RT_AVAILABLE ||
+	    !outputReady(o, r.out_vc))
+	    return false;
+
+	reservation_table.reserve(r, o);
+    }
+    else
+    {
+	o = reservation_table.getReservedOutput(r);
+
+	if (o == NOT_VALID || output_driven[o] || !outputReady(o, r.out_vc))
+	    return false;
+    }
+
+    LOG << "Input[" << i << "][" << vc << "] bypassed to Output[" << o << "], flit: " << flit << endl;
+
+    forwardFlit(i, vc, o, r.out_vc, flit);
+    bypassed_flits++;
+
+    return true;
+}
+
+void Router::deflectionTx()
+{
+    bool taken[DIRECTIONS + 2];
+    for (int o = 0; o < DIRECTIONS + 2; o++)
+	taken[o] = false;
+
+    // network inputs by age, the oldest flit choosing first
+    vector<int> inputs;
+    for (int i = 0; i < DIRECTIONS; i++)
+    {
+	if (buffer[i][DEFAULT_VC].IsEmpty())
+	    continue;
+
+	double t = buffer[i][DEFAULT_VC].Front().timestamp;
+	vector<int>::iterator it = inputs.begin();
+	while (it != inputs.end() && buffer[*it][DEFAULT_VC].Front().timestamp <= t)
+	    it++;
+	inputs.insert(it, i);
+    }
+
+    // a router has as many outputs as network inputs, so none of these
+    // flits can be left in its latch
+    for (unsigned int k = 0; k < inputs.size(); k++)
+	if (!deflectionForward(inputs[k], taken))
+	    assert(false);
+
+    // local injection only takes the outputs left free
+    if (!buffer[DIRECTION_LOCAL][DEFAULT_VC].IsEmpty())
+	deflectionForward(DIRECTION_LOCAL, taken);
+}
+
+bool Router::deflectionForward(const int i, bool taken[])
+{
+    Flit flit = buffer[i][DEFAULT_VC].Front();
+    power.bufferRouterFront();
+
+    int o = NOT_VALID;
+
+    if (flit.dst_id == local_id)
+    {
+	if (!taken[DIRECTION_LOCAL])
+	    o = DIRECTION_LOCAL;
+    }
+    else
+    {
+	// every flit is routed, as flits of a packet may part
+	RouteData route_data;
+	route_data.current_id = local_id;
+	route_data.src_id = flit.src_id;
+	route_data.dst_id = flit.dst_id;
+	route_data.dir_in = i;
+	route_data.vc_id = flit.vc_id;
+	route_data.packet_size = flit.sequence_length;
+
+	power.routing();
+	vector < int > candidate_channels = routingFunction(route_data);
+
+	vector < int > free_channels;
+	for (unsigned int k = 0; k < candidate_channels.size(); k++)
+	    if (!taken[candidate_channels[k]])
+		free_channels.push_back(candidate_channels[k]);
+
+	if (!free_channels.empty())
+	{
+	    power.selection();
+	    o = selectionFunction(free_channels, route_data);
+	}
+    }
+
+    if (o == NOT_VALID)
+    {
+	// no productive output left: deflect to any free link
+	vector < int > free_links;
+	for (int d = 0; d < DIRECTIONS; d++)
+	    if (neighbor[d] != NULL && !taken[d])
+		free_links.push_back(d);
+
+	if (free_links.empty())
+	    return false;
+
+	o = free_links[rand() % free_links.size()];
+	flit.deflections++;
+	LOG << "Input[" << i << "] deflected to Output[" << o << "], flit: " << flit << endl;
+    }
+
+    taken[o] = true;
+
+    buffer[i][DEFAULT_VC].Pop();
+    power.bufferRouterPop();
+
+    forwardFlit(i, DEFAULT_VC, o, DEFAULT_VC, flit);
+
+    return true;
+}
+
+vector<AllocRequest> Router::allocationRequests()
+{
+    vector<AllocRequest> requests;
+
+    for (int o = 0; o < DIRECTIONS + 2; o++)
+    {
+	vector<TReservation> reservations = reservation_table.getReservationsTo(o);
+
+	for (unsigned int k = 0; k < reservations.size(); k++)
+	{
+	    AllocRequest request;
+	    request.input = reservations[k].input;
+	    request.vc = reservations[k].vc;
+	    request.output = o;
+	    request.out_vc = reservations[k].out_vc;
+	    request.current = (k == 0);
+	    request.ready = !buffer[request.input][request.vc].IsEmpty() &&
+		outputReady(o, request.out_vc) &&
+		!(multicast_sent[request.input][request.vc] & (1 << o));
+	    if (!buffer[request.input][request.vc].IsEmpty())
+		request.setPriority(buffer[request.input][request.vc].Front());
+	    requests.push_back(request);
+	}
+    }
+
+    return requests;
+}
+
 NoP_data Router::getCurrentNoPData()
 {
     NoP_data NoP_data;
@@ -300,12 +805,20 @@ void Router::perCycleUpdate()
     } else {
         selectionStrategy->perCycleUpdate(this);
 
-	power.leakageRouter();
+	if (GlobalParams::router_power_gating)
+	    powerGatingUpdate();
+
+	// a gated router only leaks through its links
+	if (power_state != ROUTER_GATED)
+	    power.leakageRouter();
 	for (int i = 0; i < DIRECTIONS + 1; i++)
 	{
 	    for (int vc=0;vc<GlobalParams::n_virtual_channels;vc++)
 	    {
-		power.leakageBufferRouter();
+		// a DAMQ port is a single buffer shared by its VCs
+		if (power_state != ROUTER_GATED &&
+		    (GlobalParams::buffer_organization != BUFFER_DAMQ || vc == 0))
+		    power.leakageBufferRouter();
 		power.leakageLinkRouter2Router();
 	    }
 	}
@@ -314,6 +827,120 @@ void Router::perCycleUpdate()
     }
 }
 
+int Router::leakingBuffers() const
+{
+    int per_port = (GlobalParams::buffer_organization == BUFFER_DAMQ) ? 1 : GlobalParams::n_virtual_channels;
+
+    return (DIRECTIONS + 1) * per_port;
+}
+
+bool Router::isIdle()
+{
+    // the radio hub forwards traffic without waking the router up
+    if (hub != NULL)
+	return false;
+
+    for (int i = 0; i < DIRECTIONS + 2; i++)
+    {
+	if (req_rx[i].read() == 1 - current_level_rx[i])
+	    return false;
+
+	for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+	    if (!buffer[i][vc].IsEmpty())
+		return false;
+    }
+
+    for (int o = 0; o < DIRECTIONS + 2; o++)
+    {
+	if (!reservation_table.isNotReserved(o))
+	    return false;
+
+	// last flit sent not yet acknowledged
+	if (current_level_tx[o] != ack_tx[o].read())
+	    return false;
+    }
+
+    return true;
+}
+
+void Router::wakeUp()
+{
+    if (power_state == ROUTER_ON)
+	idle_cycles = 0;
+    else
+	wakeup_requested = true;
+}
+
+void Router::powerGatingUpdate()
+{
+    double leakage = power.getRouterLeakage(leakingBuffers());
+
+    if (power_state == ROUTER_ON)
+    {
+	idle_cycles = isIdle() ? idle_cycles + 1 : 0;
+
+	if (idle_cycles >= GlobalParams::rpg_idle_threshold)
+	{
+	    LOG << "Router gated after " << idle_cycles << " idle cycles" << endl;
+
+	    // switching off and on again costs the leakage of the
+	    // break-even time
+	    double overhead = GlobalParams::rpg_breakeven_cycles * leakage;
+	    power.powerGating(overhead);
+	    gating_saved_energy -= overhead;
+	    gating_events++;
+
+	    power_state = ROUTER_GATED;
+	    wakeup_requested = false;
+	}
+	return;
+    }
+
+    if (power_state == ROUTER_GATED)
+    {
+	if (!wakeup_requested)
+	{
+	    gated_cycles++;
+	    gating_saved_energy += leakage;
+	    return;
+	}
+
+	LOG << "Router waking up" << endl;
+	power_state = ROUTER_WAKING;
+	wakeup_countdown = GlobalParams::rpg_wakeup_latency;
+
+	// the countdown starts in the next cycle
+	if (wakeup_countdown > 0)
+	    return;
+    }
+
+    // ROUTER_WAKING: leaks, but does not accept flits yet
+    if (--wakeup_countdown <= 0)
+    {
+	power_state = ROUTER_ON;
+	idle_cycles = 0;
+	wakeup_requested = false;
+    }
+}
+
+void Router::gatedRx()
+{
+    TBufferFullStatus bfs;
+    for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+	bfs.mask[vc] = true;
+
+    for (int i = 0; i < DIRECTIONS + 2; i++)
+    {
+	// a flit waiting on the link (e.g. from the local PE, which does
+	// not look at the masks) wakes the router up
+	if (req_rx[i].read() == 1 - current_level_rx[i])
+	    wakeUp();
+
+	ack_rx[i].write(current_level_rx[i]);
+	buffer_full_status_rx[i].write(bfs);
+    }
+}
+
 vector<int> Router::nextDeltaHops(RouteData rd) {
 
 	if (GlobalParams::topology == TOPOLOGY_MESH)
@@ -413,10 +1040,15 @@ vector < int > Router::routingFunction(const RouteData & route_data)
 
                 if (connectedHubs(it1->second,it2->second))
                 {
-                    LOG << "Destination node " << route_data.dst_id << " is directly connected to a reachable RadioHub" << endl;
-                    vector<int> dirv;
-                    dirv.push_back(DIRECTION_HUB);
-                    return dirv;
+                    if (GlobalParams::winoc_routing_policy == WINOC_ROUTING_STATIC ||
+                        wirelessIsFaster(route_data, route_data.dst_id))
+                    {
+                        LOG << "Destination node " << route_data.dst_id << " is directly connected to a reachable RadioHub" << endl;
+                        vector<int> dirv;
+                        dirv.push_back(DIRECTION_HUB);
+                        return dirv;
+                    }
+                    LOG << "RadioHub congested, wired path is faster for destination " << route_data.dst_id << endl;
                 }
 			}
 			// let's check whether some node in the route has an acceptable distance to the dst
@@ -432,7 +1064,9 @@ vector < int > Router::routingFunction(const RouteData & route_data)
 				{
                 	int dest_position = nexthops.size()-1;
                 	int candidate_hop = nexthops[dest_position-i];
-					if ( hasRadioHub(candidate_hop) && !sameRadioHub(local_id,candidate_hop) ) {
+					if ( hasRadioHub(candidate_hop) && !sameRadioHub(local_id,candidate_hop) &&
+						 (GlobalParams::winoc_routing_policy == WINOC_ROUTING_STATIC ||
+						  wirelessIsFaster(route_data, candidate_hop)) ) {
 						//LOG << "Checking candidate hop " << candidate_hop << " ... It's OK!" << endl;
 						LOG << "Relaying to hub-connected node " << candidate_hop << " to reach destination " << route_data.dst_id << endl;
 						vector<int> dirv;
@@ -453,6 +1087,72 @@ vector < int > Router::routingFunction(const RouteData & route_data)
 	return routingAlgorithm->route(this, route_data);
 }
 
+int Router::wiredHops(int src, int dst) const
+{
+    if (GlobalParams::topology == TOPOLOGY_MESH)
+    {
+	Coord src_coord = id2Coord(src);
+	Coord dst_coord = id2Coord(dst);
+	return abs(src_coord.x - dst_coord.x) + abs(src_coord.y - dst_coord.y);
+    }
+
+    // delta topologies: one hop for each stage plus the core link
+    return (int) log2(GlobalParams::n_delta_tiles) + 1;
+}
+
+int Router::estimateWiredCycles(const RouteData & route_data)
+{
+    int cycles = wiredHops(local_id, route_data.dst_id) * WIRED_HOP_CYCLES + route_data.packet_size;
+
+    if (GlobalParams::topology != TOPOLOGY_MESH)
+	return cycles;
+
+    // congestion of the least loaded wired direction: flits queued in
+    // the downstream buffer plus a full buffer for busy outputs
+    vector<int> directions = routingAlgorithm->route(this, route_data);
+    int congestion = NOT_VALID;
+
+    for (unsigned int i = 0; i < directions.size(); i++)
+    {
+	int d = directions[i];
+	if (d >= DIRECTIONS) continue;
+
+	int waiting = 0;
+	if (free_slots_neighbor[d].read() != NOT_VALID)
+	    waiting += max(0, GlobalParams::buffer_depth - free_slots_neighbor[d].read());
+	if (!reservation_table.isNotReserved(d))
+	    waiting += GlobalParams::buffer_depth;
+
+	if (congestion == NOT_VALID || waiting < congestion)
+	    congestion = waiting;
+    }
+
+    if (congestion != NOT_VALID)
+	cycles += congestion;
+
+    return cycles;
+}
+
+bool Router::wirelessIsFaster(const RouteData & route_data, int target_node)
+{
+    assert(hub != NULL);
+
+    int wireless = hub->estimateWirelessCycles(tile2Hub(target_node), route_data.packet_size);
+
+    if (wireless == NOT_VALID)
+	return false;
+
+    // router->hub and hub->router links, plus remaining wired hops
+    // from a relay node to the destination
+    wireless += 2 * WIRED_HOP_CYCLES + wiredHops(target_node, route_data.dst_id) * WIRED_HOP_CYCLES;
+
+    int wired = estimateWiredCycles(route_data);
+
+    LOG << "Estimated latency to " << route_data.dst_id << ": wireless " << wireless << " cycles, wired " << wired << " cycles" << endl;
+
+    return wireless <= wired;
+}
+
 int Router::route(const RouteData & route_data)
 {
 
@@ -528,6 +1228,10 @@ void Router::configure(const int _id,
 
     reservation_table.setSize(DIRECTIONS+2);
 
+    for (int i = 0; i < DIRECTIONS; i++)
+	link_rx[i].setStages(linkStages(GlobalParams::r2r_link_stages, GlobalParams::r2r_link_length));
+    link_rx[DIRECTION_HUB].setStages(linkStages(GlobalParams::r2h_link_stages, GlobalParams::r2h_link_length));
+
     for (int i = 0; i < DIRECTIONS + 2; i++)
     {
 	for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
@@ -535,6 +1239,13 @@ void Router::configure(const int _id,
 	    buffer[i][vc].SetMaxBufferSize(_max_buffer_size);
 	    buffer[i][vc].setLabel(string(name())+"->buffer["+i_to_string(i)+"]");
 	}
+
+	if (GlobalParams::buffer_organization == BUFFER_DAMQ)
+	{
+	    buffer_pool[i] = routerInputPool();
+	    for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+		buffer[i][vc].setPool(&buffer_pool[i]);
+	}
 	start_from_vc[i] = 0;
     }
 
@@ -564,6 +1275,11 @@ unsigned long Router::getRoutedFlits()
     return routed_flits;
 }
 
+unsigned long Router::getBypassedFlits()
+{
+    return bypassed_flits;
+}
+
 
 int Router::reflexDirection(int direction) const
 {
@@ -18,22 +18,34 @@
 #include "GlobalRoutingTable.h"
 #include "LocalRoutingTable.h"
 #include "ReservationTable.h"
+#include "FlowControl.h"
 #include "Utils.h"
 #include "routingAlgorithms/RoutingAlgorithm.h"
 #include "routingAlgorithms/RoutingAlgorithms.h"
 #include "selectionStrategies/SelectionStrategy.h"
 #include "selectionStrategies/SelectionStrategy.h"
+#include "allocators/Allocator.h"
+#include "allocators/Allocators.h"
 #include "selectionStrategies/Selection_NOP.h"
 #include "selectionStrategies/Selection_BUFFER_LEVEL.h"
+#include "selectionStrategies/Selection_RCA.h"
 
 using namespace std;
 
 extern unsigned int drained_volume;
 
+// Power states of a router (router_power_gating)
+#define ROUTER_ON      0
+#define ROUTER_GATED   1
+#define ROUTER_WAKING  2
+
+struct Hub;
+
 SC_MODULE(Router)
 {
     friend class Selection_NOP;
     friend class Selection_BUFFER_LEVEL;
+    friend class Selection_RCA;
 
     // I/O Ports
     sc_in_clk clock;		                  // The input clock for the router
@@ -63,15 +75,39 @@ SC_MODULE(Router)
     int routing_type;		                // Type of routing algorithm
     int selection_type;
     BufferBank buffer[DIRECTIONS + 2];		// buffer[direction][virtual_channel] 
+    BufferPool buffer_pool[DIRECTIONS + 2];	// Slots shared by the VCs of each input (DAMQ)
     bool current_level_rx[DIRECTIONS + 2];	// Current level for Alternating Bit Protocol (ABP)
     bool current_level_tx[DIRECTIONS + 2];	// Current level for Alternating Bit Protocol (ABP)
+    LinkReceiver link_rx[DIRECTIONS + 2];	// Input link pipelines (credit based flow control)
+    LinkSender link_tx[DIRECTIONS + 2];		// Output credits (credit based flow control)
+    bool output_driven[DIRECTIONS + 2];		// Outputs which already sent a flit in this cycle
     Stats stats;		                // Statistics
     Power power;
     LocalRoutingTable routing_table;		// Routing table
     ReservationTable reservation_table;		// Switch reservation table
     unsigned long routed_flits;
+    unsigned long bypassed_flits;		// Flits forwarded without being buffered
     RoutingAlgorithm * routingAlgorithm; 
+    RoutingAlgorithm * escapeRouting;		// Routing of the escape VC (FULLY_ADAPTIVE only)
     SelectionStrategy * selectionStrategy; 
+    Allocator * allocator;
+    AllocatorState allocator_state;
+    Hub * hub;					// Radio hub attached to the router (if any)
+    Router * neighbor[DIRECTIONS];		// Adjacent routers (mesh only), used by lookahead routing
+
+    // Multicast: tree branches (output -> destinations) of the packet
+    // at each input/VC, and outputs which already got its front flit
+    map < int, DestinationSet > multicast_branches[DIRECTIONS + 2][MAX_VIRTUAL_CHANNELS];
+    int multicast_sent[DIRECTIONS + 2][MAX_VIRTUAL_CHANNELS];
+
+    // Power gating
+    int power_state;				// ROUTER_ON, ROUTER_GATED or ROUTER_WAKING
+    int idle_cycles;				// Consecutive cycles without traffic
+    int wakeup_countdown;			// Cycles left before a waking router is on
+    bool wakeup_requested;
+    unsigned long gated_cycles;
+    unsigned long gating_events;
+    double gating_saved_energy;			// Leakage not spent, net of the gating overheads
     
     // Functions
 
@@ -84,6 +120,11 @@ SC_MODULE(Router)
 		   GlobalRoutingTable & grt);
 
     unsigned long getRoutedFlits();	// Returns the number of routed flits 
+    unsigned long getBypassedFlits();	// Returns the number of flits which skipped the input buffers
+
+    // asks a gated router to power on, e.g. because a neighbor reserved
+    // an output towards it (lookahead wake-up)
+    void wakeUp();
 
     // Constructor
 
@@ -96,6 +137,10 @@ SC_MODULE(Router)
         sensitive << reset;
         sensitive << clock.pos();
 
+        hub = NULL;
+        for (int i = 0; i < DIRECTIONS; i++)
+            neighbor[i] = NULL;
+
         routingAlgorithm = RoutingAlgorithms::get(GlobalParams::routing_algorithm);
 
         if (routingAlgorithm == 0)
@@ -104,6 +149,14 @@ SC_MODULE(Router)
             exit(-1);
         }
 
+        escapeRouting = RoutingAlgorithms::get(GlobalParams::escape_routing);
+
+        if (GlobalParams::routing_algorithm == ROUTING_FULLY_ADAPTIVE && escapeRouting == 0)
+        {
+            cerr << " FATAL: invalid escape routing " << GlobalParams::escape_routing << ", check with noxim -help" << endl;
+            exit(-1);
+        }
+
         selectionStrategy = SelectionStrategies::get(GlobalParams::selection_strategy);
 
         if (selectionStrategy == 0)
@@ -111,6 +164,16 @@ SC_MODULE(Router)
             cerr << " FATAL: invalid selection strategy -sel " << GlobalParams::selection_strategy << ", check with noxim -help" << endl;
             exit(-1);
         }
+
+        allocator = Allocators::get(GlobalParams::allocator);
+
+        if (allocator == 0)
+        {
+            cerr << " FATAL: invalid allocator -alloc " << GlobalParams::allocator << ", check with noxim -help" << endl;
+            exit(-1);
+        }
+
+        allocator_state.setSize(DIRECTIONS + 2, DIRECTIONS + 2, GlobalParams::n_virtual_channels);
     }
 
   private:
@@ -122,6 +185,63 @@ SC_MODULE(Router)
     int selectionFunction(const vector <int> &directions,
 			  const RouteData & route_data);
     vector < int >routingFunction(const RouteData & route_data);
+
+    // collects the reserved input/VC waiting for their output
+    vector<AllocRequest> allocationRequests();
+
+    // true when a flit of vc can be sent on output o in this cycle
+    bool outputReady(const int o, const int vc);
+
+    // samples input i and moves the flits leaving its link pipeline
+    // to the input buffers (credit based flow control)
+    void creditRx(const int i);
+
+    // sends flit from input i/vc to output o, updating reservations,
+    // power and stats
+    void forwardFlit(const int i, const int vc, const int o, const int out_vc, Flit flit);
+
+    // FULLY_ADAPTIVE routing: allocates output and output VC (in r)
+    // following Duato's protocol. Returns NOT_VALID when no VC is free
+    int adaptiveRoute(const RouteData & route_data, TReservation & r);
+
+    // first VC in [first_vc, last_vc] not reserved on output o, or NOT_VALID
+    int freeOutputVC(const int o, const int first_vc, const int last_vc);
+
+    // output port that flit will take at the router reached through o
+    int lookaheadRoute(const int o, const Flit & flit);
+
+    // forwards a flit just received on input i without buffering it,
+    // when its output is known, free and not yet driven in this cycle.
+    // Returns false otherwise
+    bool bypass(const int i, Flit flit);
+
+    // splits the destinations of the multicast head flit at input i
+    // among the outputs of the XY tree
+    map < int, DestinationSet > multicastRoute(const int i, const Flit & flit);
+
+    // true if dst is reached by the broadcast of the local radio hub,
+    // whatever channel the hub transmits on
+    bool multicastOverRadio(const int dst) const;
+
+    // sends a copy of the front flit of input i/vc on branch o, popping
+    // it once every branch has been served
+    void forwardMulticast(const int i, const int vc, const int o, const int out_vc, Flit flit);
+
+    // DEFLECTION routers: sends every flit latched at the inputs, oldest
+    // first, to a free output (taken marks the outputs already used)
+    void deflectionTx();
+    // returns false if no output is left for the flit at input i
+    bool deflectionForward(const int i, bool taken[]);
+
+    // power gating: true when no flit is stored, reserved or incoming
+    bool isIdle();
+    // advances the ON -> GATED -> WAKING -> ON state machine
+    void powerGatingUpdate();
+    // input side of a gated or waking router: every VC looks full and
+    // incoming requests only wake the router up
+    void gatedRx();
+    // number of input buffers accounted for in the router leakage
+    int leakingBuffers() const;
  
     NoP_data getCurrentNoPData();
     void NoP_report() const;
@@ -134,6 +254,11 @@ SC_MODULE(Router)
     int start_from_vc[DIRECTIONS+2]; // VC from which to start the reservation cycle for the specific port
 
     vector<int> nextDeltaHops(RouteData rd);
+
+    // adaptive wireless vs wired path selection
+    bool wirelessIsFaster(const RouteData & route_data, int target_node);
+    int estimateWiredCycles(const RouteData & route_data);
+    int wiredHops(int src, int dst) const;
   public:
     unsigned int local_drained;
 
@@ -16,11 +16,27 @@ void Stats::configure(const int node_id, const double _warm_up_time)
 {
     id = node_id;
     warm_up_time = _warm_up_time;
+    deflections = 0;
+    source_delay_sum = 0.0;
+    source_delays = 0;
 }
 
 void Stats::receivedFlit(const double arrival_time,
 			      const Flit & flit)
 {
+    // flits of a packet can be deflected on different paths: the
+    // packet is delivered when its last flit, in any order, arrives.
+    // Flits are also counted during the warm-up, so that the packets
+    // crossing its end are completed
+    bool delivered = false;
+    if (GlobalParams::router_architecture == ROUTER_DEFLECTION)
+    {
+	pair < int, int > packet(flit.src_id, flit.packet_id);
+	delivered = (++reassembly[packet] == flit.sequence_length);
+	if (delivered)
+	    reassembly.erase(packet);
+    }
+
     if (arrival_time - GlobalParams::reset_time < warm_up_time)
 	return;
 
@@ -38,8 +54,27 @@ void Stats::receivedFlit(const double arrival_time,
 	i = chist.size() - 1;
     }
 
-    if (flit.flit_type == FLIT_TYPE_HEAD)
+    if (GlobalParams::router_architecture == ROUTER_DEFLECTION)
+    {
+	if (delivered)
+	{
+	    chist[i].delays.push_back(arrival_time - flit.timestamp);
+	    class_delays[flit.traffic_class].push_back(arrival_time - flit.timestamp);
+	    source_delay_sum += flit.injection_timestamp - flit.timestamp;
+	    source_delays++;
+	}
+	deflections += flit.deflections;
+    }
+    else if (flit.flit_type == FLIT_TYPE_HEAD)
+    {
 	chist[i].delays.push_back(arrival_time - flit.timestamp);
+	class_delays[flit.traffic_class].push_back(arrival_time - flit.timestamp);
+	source_delay_sum += flit.injection_timestamp - flit.timestamp;
+	source_delays++;
+
+	if (flit.dst_set.any())
+	    multicast_delays[make_pair(flit.src_id, flit.timestamp)] = arrival_time - flit.timestamp;
+    }
 
     chist[i].total_received_flits++;
     chist[i].last_received_flit_time = arrival_time - warm_up_time;
@@ -183,6 +218,29 @@ double Stats::getCommunicationEnergy(int src_id, int dst_id)
   return -1.0;
 }
 
+const vector < double > & Stats::getClassDelays(const int traffic_class)
+{
+    return class_delays[traffic_class];
+}
+
+double Stats::getAverageSourceDelay()
+{
+    if (source_delays == 0)
+	return 0.0;
+
+    return source_delay_sum / source_delays;
+}
+
+unsigned long Stats::getDeflections()
+{
+    return deflections;
+}
+
+const map < pair < int, double >, double > & Stats::getMulticastDelays()
+{
+    return multicast_delays;
+}
+
 int Stats::searchCommHistory(int src_id)
 {
     for (unsigned int i = 0; i < chist.size(); i++)
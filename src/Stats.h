@@ -14,6 +14,7 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <map>
 #include "DataStructs.h"
 #include "Power.h"
 using namespace std;
@@ -74,6 +75,22 @@ class Stats {
     // average between the minimum and the maximum packet size).
     double getCommunicationEnergy(int src_id, int dst_id);
 
+    // Returns the delays (cycles) of the packets of the given QoS class
+    // received by the current node
+    const vector < double > & getClassDelays(const int traffic_class);
+
+    // Returns the average time (cycles) the packets received by the
+    // current node waited in the source queue, before the network
+    double getAverageSourceDelay();
+
+    // Returns the deflections suffered by the flits received by the
+    // current node
+    unsigned long getDeflections();
+
+    // Returns the delays (cycles) of the multicast packets received by
+    // the current node, by source and generation time of the packet
+    const map < pair < int, double >, double > & getMulticastDelays();
+
     // Shows statistics for the current node
     void showStats(int curr_node, std::ostream & out =
 		   std::cout, bool header = false);
@@ -83,7 +100,13 @@ class Stats {
 
     int id;
     vector < CommHistory > chist;
+    map < int, vector < double > > class_delays;
     double warm_up_time;
+    unsigned long deflections;
+    double source_delay_sum;	// Source queuing delays of the received packets
+    unsigned long source_delays;
+    map < pair < int, double >, double > multicast_delays;
+    map < pair < int, int >, int > reassembly;	// Flits received so far, by source and packet id (DEFLECTION)
 
     int searchCommHistory(int src_id);
 };
@@ -0,0 +1,184 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the application task graph
+ */
+
+#include "TaskGraph.h"
+
+#include <fstream>
+#include <map>
+#include <queue>
+
+TaskGraph::TaskGraph()
+{
+    completed = 0;
+    makespan = 0.0;
+}
+
+bool TaskGraph::load(const char *fname, const int n_nodes)
+{
+    // Open file
+    ifstream fin(fname, ios::in);
+    if (!fin)
+    {
+	cerr << "Error: cannot open task graph " << fname << endl;
+	return false;
+    }
+
+    tasks.clear();
+    edges.clear();
+    map < int, int > task_index;	// task id -> index in tasks
+
+    // Cycle reading file. Lines are either
+    //   task ID TILE COMPUTE_CYCLES
+    //   edge SRC_ID DST_ID SIZE
+    // or comments starting with %
+    int line_no = 0;
+    while (!fin.eof()) {
+	char line[512];
+	fin.getline(line, sizeof(line) - 1);
+	line_no++;
+
+	if (line[0] == '\0' || line[0] == '%')
+	    continue;
+
+	char kind[16];
+	int a, b, c;
+	if (sscanf(line, "%15s %d %d %d", kind, &a, &b, &c) != 4)
+	{
+	    cerr << "Error: " << fname << ":" << line_no << ": invalid line" << endl;
+	    return false;
+	}
+
+	if (!strcmp(kind, "task"))
+	{
+	    if (task_index.count(a) || b < 0 || b >= n_nodes || c < 0)
+	    {
+		cerr << "Error: " << fname << ":" << line_no << ": invalid or duplicated task " << a << endl;
+		return false;
+	    }
+
+	    Task task;
+	    task.id = a;
+	    task.tile = b;
+	    task.compute_cycles = c;
+	    task.pending_messages = 0;
+	    task.completion_time = -1;
+
+	    task_index[a] = tasks.size();
+	    tasks.push_back(task);
+	}
+	else if (!strcmp(kind, "edge"))
+	{
+	    if (!task_index.count(a) || !task_index.count(b) || a == b || c < 2)
+	    {
+		cerr << "Error: " << fname << ":" << line_no << ": invalid edge " << a << " -> " << b
+		     << " (tasks must be declared first, messages are at least 2 flits)" << endl;
+		return false;
+	    }
+
+	    TaskEdge edge;
+	    edge.src = task_index[a];
+	    edge.dst = task_index[b];
+	    edge.size = c;
+	    // packets of at most max_packet_size flits, each one at least 2
+	    edge.packets = (c + GlobalParams::max_packet_size - 1) / GlobalParams::max_packet_size;
+	    if (edge.packets > c / 2)
+		edge.packets = c / 2;
+	    edge.pending_packets = edge.packets;
+
+	    tasks[edge.src].out_edges.push_back(edges.size());
+	    tasks[edge.dst].pending_messages++;
+	    edges.push_back(edge);
+	}
+	else
+	{
+	    cerr << "Error: " << fname << ":" << line_no << ": unknown entry " << kind << endl;
+	    return false;
+	}
+    }
+
+    // a cycle of dependencies would never start: check that every task
+    // is reached from the initial ones
+    vector < int > inputs(tasks.size());
+    queue < int > ready;
+    for (unsigned int t = 0; t < tasks.size(); t++)
+    {
+	inputs[t] = tasks[t].pending_messages;
+	if (inputs[t] == 0)
+	    ready.push(t);
+    }
+
+    unsigned int visited = 0;
+    while (!ready.empty())
+    {
+	int t = ready.front();
+	ready.pop();
+	visited++;
+
+	for (unsigned int i = 0; i < tasks[t].out_edges.size(); i++)
+	    if (--inputs[edges[tasks[t].out_edges[i]].dst] == 0)
+		ready.push(edges[tasks[t].out_edges[i]].dst);
+    }
+
+    if (visited != tasks.size())
+    {
+	cerr << "Error: task graph " << fname << " has cyclic dependencies" << endl;
+	return false;
+    }
+
+    completed = 0;
+    makespan = 0.0;
+
+    return true;
+}
+
+vector < int > TaskGraph::initialTasks(const int tile) const
+{
+    vector < int > initial;
+
+    for (unsigned int t = 0; t < tasks.size(); t++)
+	if (tasks[t].tile == tile && tasks[t].pending_messages == 0)
+	    initial.push_back(t);
+
+    return initial;
+}
+
+int TaskGraph::occurrencesAsTile(const int tile) const
+{
+    int n = 0;
+
+    for (unsigned int t = 0; t < tasks.size(); t++)
+	if (tasks[t].tile == tile)
+	    n++;
+
+    return n;
+}
+
+int TaskGraph::packetDelivered(const int e)
+{
+    assert(edges[e].pending_packets > 0);
+
+    if (--edges[e].pending_packets > 0)
+	return NOT_VALID;
+
+    int t = edges[e].dst;
+    if (--tasks[t].pending_messages > 0)
+	return NOT_VALID;
+
+    return t;
+}
+
+void TaskGraph::taskCompleted(const int t, const double time)
+{
+    tasks[t].completion_time = time;
+    completed++;
+
+    if (time > makespan)
+	makespan = time;
+}
@@ -0,0 +1,77 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the application task graph
+ * (TRAFFIC_TASK_GRAPH)
+ */
+
+#ifndef __NOXIMTASKGRAPH_H__
+#define __NOXIMTASKGRAPH_H__
+
+#include <vector>
+#include "DataStructs.h"
+
+using namespace std;
+
+// A task of the application, executed by the PE of its tile
+struct Task {
+    int id;			// ID of the task in the task graph file
+    int tile;			// PE executing the task
+    int compute_cycles;		// Time (in cycles) spent computing once ready
+    vector < int > out_edges;	// Messages sent at the end of the computation
+    int pending_messages;	// Incoming messages not yet arrived
+    double completion_time;	// Cycle at which the computation ended, -1 before
+};
+
+// A message between two tasks
+struct TaskEdge {
+    int src;			// Sending task (index in the task vector)
+    int dst;			// Receiving task (index in the task vector)
+    int size;			// Message size [flits]
+    int packets;		// Packets the message is split into
+    int pending_packets;	// Packets not yet arrived
+};
+
+class TaskGraph {
+
+  public:
+
+    TaskGraph();
+
+    // Load task graph from file. Returns true if ok, false otherwise
+    bool load(const char *fname, const int n_nodes);
+
+    Task & getTask(const int t) { return tasks[t]; }
+    TaskEdge & getEdge(const int e) { return edges[e]; }
+
+    // Tasks with no incoming messages, ready at the end of the reset
+    vector < int > initialTasks(const int tile) const;
+
+    // Returns the number of tasks mapped on tile
+    int occurrencesAsTile(const int tile) const;
+
+    // A packet of message e arrived. Returns the receiving task if this
+    // was the last message it waited for, NOT_VALID otherwise
+    int packetDelivered(const int e);
+
+    void taskCompleted(const int t, const double time);
+    bool allCompleted() const { return completed == (int)tasks.size(); }
+
+    int size() const { return tasks.size(); }
+    int getCompletedTasks() const { return completed; }
+    // Cycle at which the last task completed (after the reset)
+    double getMakespan() const { return makespan; }
+
+  private:
+
+    vector < Task > tasks;
+    vector < TaskEdge > edges;
+    int completed;
+    double makespan;
+};
+
+#endif
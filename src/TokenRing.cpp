@@ -68,6 +68,37 @@ void TokenRing::updateTokenHold(int channel)
 	current_token_expiration[channel]->write(token_hold_count[channel]);
 }
 
+int TokenRing::estimateTokenWait(int channel, int hub)
+{
+    vector<int> & ring = rings_mapping[channel];
+    int num_hubs = ring.size();
+
+    int hub_position = find(ring.begin(), ring.end(), hub) - ring.begin();
+    assert(hub_position < num_hubs);
+
+    // number of ring hops the token must travel to reach the hub
+    int distance = (hub_position - token_position[channel] + num_hubs) % num_hubs;
+
+    string macPolicy = getPolicy(channel).first;
+
+    if (distance == 0 || macPolicy == SPATIAL_REUSE)
+	return 0;
+
+    // hubs having nothing to transmit release the token in one cycle
+    if (macPolicy == TOKEN_PACKET)
+	return distance;
+
+    int hold_cycles = atoi(GlobalParams::channel_configuration[channel].macPolicy[1].c_str());
+
+    // the current holder keeps the token until expiration, each of the
+    // following hubs holds it for the whole period
+    if (macPolicy == TOKEN_HOLD)
+	return token_hold_count[channel] + (distance - 1) * hold_cycles;
+
+    // TOKEN_MAX_HOLD: idle hubs release the token immediately
+    return token_hold_count[channel] + (distance - 1);
+}
+
 void TokenRing::updateTokens()
 {
     if (reset.read()) {
@@ -93,6 +124,8 @@ void TokenRing::updateTokens()
                 updateTokenHold(channel);
             else if (macPolicy == TOKEN_MAX_HOLD)
                 updateTokenMaxHold(channel);
+            else if (macPolicy == SPATIAL_REUSE)
+                ; // no token, access is granted by the Channel
             else
                 assert(false);
         }
@@ -122,7 +155,8 @@ void TokenRing::attachHub(int channel, int hub, sc_in<int>* hub_token_holder_por
         token_hold_count[channel] = 0;
 
 
-        if (GlobalParams::channel_configuration[channel].macPolicy[0] != TOKEN_PACKET) {
+        if (GlobalParams::channel_configuration[channel].macPolicy[0] == TOKEN_HOLD ||
+            GlobalParams::channel_configuration[channel].macPolicy[0] == TOKEN_MAX_HOLD) {
             // checking max hold cycles vs wireless transmission latency
             // consistency
             //TODO move this check: max_hold_cycles depends on the Channel not on the Hub
@@ -15,6 +15,7 @@
 
 #include "Utils.h"
 #include <stdlib.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -60,6 +61,12 @@ SC_MODULE(TokenRing)
 
     pair<string, vector<string> > getPolicy(int channel) { return token_policy[channel];}
 
+    // Remaining cycles before the token of channel is passed (hold policies)
+    int getTokenExpiration(int channel) { return token_hold_count[channel]; }
+
+    // Estimated number of cycles before the token of channel reaches hub
+    int estimateTokenWait(int channel, int hub);
+
     private:
 
     void updateTokenMaxHold(int channel);
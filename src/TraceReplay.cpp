@@ -0,0 +1,195 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the binary trace replayed by
+ * the processing elements
+ */
+
+#include "TraceReplay.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <climits>
+#include <cstring>
+
+TraceReplay::TraceReplay()
+{
+    fd = -1;
+    map = NULL;
+    map_size = 0;
+    index = NULL;
+    records = NULL;
+    n_sources = 0;
+    n_nodes = 0;
+    n_records = 0;
+    injected = 0;
+}
+
+TraceReplay::~TraceReplay()
+{
+    if (map != NULL)
+	munmap(map, map_size);
+    if (fd >= 0)
+	close(fd);
+}
+
+bool TraceReplay::load(const char *fname, const int _n_nodes)
+{
+    fd = open(fname, O_RDONLY);
+    if (fd < 0)
+    {
+	cerr << "Error: cannot open trace " << fname << endl;
+	return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(TraceHeader))
+    {
+	cerr << "Error: " << fname << " is not a trace file" << endl;
+	return false;
+    }
+
+    // the trace is never read as a whole: pages are only faulted in
+    // within the read-ahead window of each source
+    map_size = st.st_size;
+    map = (char *) mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+	map = NULL;
+	cerr << "Error: cannot map trace " << fname << endl;
+	return false;
+    }
+    // the sources read interleaved streams, the default read-around
+    // would mostly bring in records of other sources
+    madvise(map, map_size, MADV_RANDOM);
+
+    const TraceHeader * header = (const TraceHeader *) map;
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+	header->version != TRACE_VERSION)
+    {
+	cerr << "Error: " << fname << " is not a version " << TRACE_VERSION << " trace file" << endl;
+	return false;
+    }
+
+    n_nodes = _n_nodes;
+    n_sources = header->n_sources;
+    n_records = header->n_records;
+    if ((int)n_sources != n_nodes)
+    {
+	cerr << "Error: trace " << fname << " has " << n_sources << " sources, the NoC " << n_nodes << " nodes" << endl;
+	return false;
+    }
+    if (header->n_ids > (uint32_t)INT_MAX)
+    {
+	cerr << "Error: trace " << fname << " has more than " << INT_MAX << " packet ids" << endl;
+	return false;
+    }
+
+    size_t records_offset = sizeof(TraceHeader) + n_sources * sizeof(TraceIndex);
+    if (map_size != records_offset + n_records * sizeof(TraceRecord))
+    {
+	cerr << "Error: trace " << fname << " is truncated" << endl;
+	return false;
+    }
+
+    index = (const TraceIndex *) (map + sizeof(TraceHeader));
+    records = (const TraceRecord *) (map + records_offset);
+
+    next.resize(n_sources);
+    window_end.resize(n_sources);
+    released.resize(n_sources);
+    for (uint32_t s = 0; s < n_sources; s++)
+    {
+	if (index[s].first + index[s].count > n_records)
+	{
+	    cerr << "Error: trace " << fname << " has an invalid index for source " << s << endl;
+	    return false;
+	}
+	next[s] = released[s] = window_end[s] = index[s].first;
+	readAhead(s);
+    }
+
+    delivered_ids.assign(header->n_ids, false);
+    injected = 0;
+
+    return true;
+}
+
+const TraceRecord * TraceReplay::front(const int src)
+{
+    if (next[src] == index[src].first + index[src].count)
+	return NULL;
+
+    const TraceRecord * r = &records[next[src]];
+
+    if ((int)r->src != src || (int)r->dst < 0 || (int)r->dst >= n_nodes || (int)r->dst == src ||
+	r->size < 2 || r->id >= delivered_ids.size() ||
+	(r->dep_id != TRACE_NO_DEPENDENCY && r->dep_id >= delivered_ids.size()) ||
+	(next[src] > index[src].first && records[next[src] - 1].cycle > r->cycle))
+    {
+	cerr << "Error: invalid trace record " << next[src] << " (src " << r->src << ", dst " << r->dst
+	     << ", size " << r->size << ", cycle " << r->cycle << ")" << endl;
+	exit(1);
+    }
+
+    return r;
+}
+
+void TraceReplay::pop(const int src)
+{
+    next[src]++;
+    injected++;
+    readAhead(src);
+}
+
+void TraceReplay::readAhead(const int src)
+{
+    uint64_t end = index[src].first + index[src].count;
+
+    // more than half of the window is still to be injected
+    if (window_end[src] == end || window_end[src] - next[src] > TRACE_READ_AHEAD / 2)
+	return;
+
+    uint64_t to = window_end[src] + TRACE_READ_AHEAD;
+    if (to > end)
+	to = end;
+
+    advise(window_end[src], to, MADV_WILLNEED);
+    window_end[src] = to;
+
+    // the records already injected are not needed anymore
+    advise(released[src], next[src], MADV_DONTNEED);
+    released[src] = next[src];
+}
+
+void TraceReplay::advise(const uint64_t from, const uint64_t to, const int advice)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t offset = (const char *) &records[from] - map;
+    size_t begin = offset / page * page;
+    size_t length = (const char *) &records[to] - map - begin;
+
+    if (to > from)
+	madvise(map + begin, length, advice);
+}
+
+uint64_t TraceReplay::occurrencesAsSource(const int src_id) const
+{
+    return index[src_id].count;
+}
+
+void TraceReplay::delivered(const int id)
+{
+    delivered_ids[id] = true;
+}
+
+bool TraceReplay::isDelivered(const int id) const
+{
+    return delivered_ids[id];
+}
@@ -0,0 +1,105 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the binary trace replayed by the
+ * processing elements (TRAFFIC_TRACE_REPLAY)
+ */
+
+#ifndef __NOXIMTRACEREPLAY_H__
+#define __NOXIMTRACEREPLAY_H__
+
+#include <stdint.h>
+#include <vector>
+#include "DataStructs.h"
+
+using namespace std;
+
+#define TRACE_MAGIC		"NXTR"
+#define TRACE_VERSION		1
+#define TRACE_NO_DEPENDENCY	0xFFFFFFFF
+
+// Records of each source advised to the kernel ahead of their injection
+#define TRACE_READ_AHEAD	4096
+
+// Layout of the trace file (native byte order, see other/trace2bin.cpp):
+//   TraceHeader
+//   TraceIndex  [n_sources]	where the records of each source are
+//   TraceRecord [n_records]	grouped by source, by cycle within a source
+struct TraceHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t n_sources;		// must match the number of PEs
+    uint32_t n_ids;		// record ids are in [0, n_ids)
+    uint64_t n_records;
+};
+
+struct TraceIndex {
+    uint64_t first;		// first record of the source
+    uint64_t count;		// number of records of the source
+};
+
+struct TraceRecord {
+    uint64_t cycle;		// injection cycle, counted from the end of the reset
+    uint32_t id;		// packet identifier
+    uint32_t dep_id;		// packet to be delivered first, TRACE_NO_DEPENDENCY if none
+    uint32_t src;
+    uint32_t dst;
+    uint32_t size;		// packet size [flits]
+    uint32_t reserved;
+};
+
+class TraceReplay {
+
+  public:
+
+    TraceReplay();
+    ~TraceReplay();
+
+    // Maps the trace file, without reading the records. Returns true
+    // if ok, false otherwise
+    bool load(const char *fname, const int n_nodes);
+
+    // Next record to be injected by src, NULL when its stream is over
+    const TraceRecord * front(const int src);
+
+    // Moves src to its next record
+    void pop(const int src);
+
+    // Returns the number of records of source src_id
+    uint64_t occurrencesAsSource(const int src_id) const;
+
+    // Dependency tracking: the tail of packet id reached its destination
+    void delivered(const int id);
+    bool isDelivered(const int id) const;
+
+    uint64_t getRecords() const { return n_records; }
+    uint64_t getInjected() const { return injected; }
+
+  private:
+
+    // advises the window following the records already requested by
+    // src, and drops the ones it injected
+    void readAhead(const int src);
+    void advise(const uint64_t from, const uint64_t to, const int advice);
+
+    int fd;
+    char * map;
+    size_t map_size;
+    const TraceIndex * index;
+    const TraceRecord * records;
+    uint32_t n_sources;
+    int n_nodes;
+    uint64_t n_records;
+    uint64_t injected;
+
+    vector < uint64_t > next;		// next record of each source
+    vector < uint64_t > window_end;	// end of the records requested by each source
+    vector < uint64_t > released;	// records of each source already dropped
+    vector < bool > delivered_ids;	// one bit per packet id
+};
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the implementation of the traffic table generator
+ */
+
+#include "TrafficTableGenerator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+TrafficTableGenerator::TrafficTableGenerator(const int _dim_x, const int _dim_y)
+{
+    dim_x = _dim_x;
+    dim_y = _dim_y;
+    n_nodes = dim_x * dim_y;
+}
+
+bool TrafficTableGenerator::add(const TrafficPattern & pattern)
+{
+    if (n_nodes < 2)
+    {
+	cerr << "Error: traffic patterns need at least two nodes" << endl;
+	return false;
+    }
+
+    if (pattern.pattern == PATTERN_REGIONS)
+	return regions(pattern);
+
+    if (pattern.pattern == PATTERN_DISTANCE)
+	return distanceBased(pattern);
+
+    if (pattern.rate <= 0.0 || pattern.rate > 1.0)
+    {
+	cerr << "Error: the rate of the " << pattern.pattern << " pattern must be in ]0,1]" << endl;
+	return false;
+    }
+
+    if (pattern.pattern == PATTERN_UNIFORM)
+    {
+	double pir = pattern.rate / (n_nodes - 1);
+	for (int src = 0; src < n_nodes; src++)
+	    for (int dst = 0; dst < n_nodes; dst++)
+		if (dst != src)
+		    addCommunication(src, dst, pir);
+	return true;
+    }
+
+    if (pattern.pattern == PATTERN_HOTSPOT)
+    {
+	if (pattern.nodes.empty() || pattern.fraction < 0.0 || pattern.fraction > 1.0)
+	{
+	    cerr << "Error: the hotspot pattern needs hotspot nodes and a fraction in [0,1]" << endl;
+	    return false;
+	}
+
+	vector < bool > hotspot(n_nodes, false);
+	for (unsigned int i = 0; i < pattern.nodes.size(); i++)
+	{
+	    if (pattern.nodes[i] < 0 || pattern.nodes[i] >= n_nodes)
+	    {
+		cerr << "Error: hotspot node " << pattern.nodes[i] << " is invalid (out of range)" << endl;
+		return false;
+	    }
+	    hotspot[pattern.nodes[i]] = true;
+	}
+
+	// the hotspot share of each source is split among the hotspots
+	// other than itself, the rest is uniform
+	vector < double > pir(n_nodes);
+	for (int src = 0; src < n_nodes; src++)
+	{
+	    int n_hotspots = 0;
+	    for (int dst = 0; dst < n_nodes; dst++)
+		if (hotspot[dst] && dst != src)
+		    n_hotspots++;
+
+	    double uniform = pattern.rate * (n_hotspots > 0 ? 1.0 - pattern.fraction : 1.0) / (n_nodes - 1);
+	    for (int dst = 0; dst < n_nodes; dst++)
+	    {
+		pir[dst] = uniform;
+		if (hotspot[dst] && dst != src)
+		    pir[dst] += pattern.rate * pattern.fraction / n_hotspots;
+	    }
+
+	    for (int dst = 0; dst < n_nodes; dst++)
+		if (dst != src && pir[dst] > 0.0)
+		    addCommunication(src, dst, pir[dst]);
+	}
+	return true;
+    }
+
+    return permutation(pattern.pattern, pattern.rate);
+}
+
+void TrafficTableGenerator::addCommunication(const int src, const int dst, const double pir)
+{
+    Communication communication;
+
+    communication.src = src;
+    communication.dst = dst;
+    communication.pir = pir;
+    communication.por = pir;
+    communication.t_on = 0;
+    communication.t_off = TRAFFIC_TABLE_FOREVER;
+    communication.t_period = TRAFFIC_TABLE_FOREVER;
+    communication.traffic_class = 0;
+
+    table.push_back(communication);
+}
+
+bool TrafficTableGenerator::permutation(const string & pattern, const double rate)
+{
+    if (pattern != PATTERN_TRANSPOSE1 && pattern != PATTERN_TRANSPOSE2 &&
+	pattern != PATTERN_BIT_REVERSAL && pattern != PATTERN_SHUFFLE && pattern != PATTERN_BUTTERFLY)
+    {
+	cerr << "Error: unknown traffic pattern " << pattern << endl;
+	return false;
+    }
+
+    // the bit permutations only map the nodes onto themselves when
+    // they are a power of two
+    if (pattern != PATTERN_TRANSPOSE1 && pattern != PATTERN_TRANSPOSE2 && (n_nodes & (n_nodes - 1)) != 0)
+    {
+	cerr << "Error: the " << pattern << " pattern needs a power of two number of nodes" << endl;
+	return false;
+    }
+
+    for (int src = 0; src < n_nodes; src++)
+    {
+	int dst = permutationDestination(pattern, src);
+	if (dst != src)
+	    addCommunication(src, dst, rate);
+    }
+
+    return true;
+}
+
+// Same destinations as the corresponding traffic distributions of the
+// processing elements
+int TrafficTableGenerator::permutationDestination(const string & pattern, const int src) const
+{
+    if (pattern == PATTERN_TRANSPOSE1 || pattern == PATTERN_TRANSPOSE2)
+    {
+	int x = src % dim_x;
+	int y = src / dim_x;
+	int dst_x = (pattern == PATTERN_TRANSPOSE1) ? dim_x - 1 - y : y;
+	int dst_y = (pattern == PATTERN_TRANSPOSE1) ? dim_y - 1 - x : x;
+
+	// non square meshes: clamped, as ProcessingElement::fixRanges()
+	dst_x = max(0, min(dst_x, dim_x - 1));
+	dst_y = max(0, min(dst_y, dim_y - 1));
+
+	return dst_y * dim_x + dst_x;
+    }
+
+    int nbits = 0;
+    while ((1 << nbits) < n_nodes)
+	nbits++;
+
+    int dst = 0;
+    if (pattern == PATTERN_BIT_REVERSAL)
+    {
+	for (int i = 0; i < nbits; i++)
+	    dst |= ((src >> (nbits - i - 1)) & 1) << i;
+    }
+    else if (pattern == PATTERN_SHUFFLE)
+    {
+	// rotate left
+	dst = ((src << 1) | (src >> (nbits - 1))) & (n_nodes - 1);
+    }
+    else // PATTERN_BUTTERFLY: swap the most and least significant bits
+    {
+	dst = src & ~(1 | (1 << (nbits - 1)));
+	dst |= (src >> (nbits - 1)) & 1;
+	dst |= (src & 1) << (nbits - 1);
+    }
+
+    return dst;
+}
+
+bool TrafficTableGenerator::regions(const TrafficPattern & pattern)
+{
+    if (pattern.src_region.size() != 2 || pattern.dst_region.size() != 2 ||
+	pattern.rate < 0.0 || pattern.rate_max < pattern.rate || pattern.rate_max > 1.0)
+    {
+	cerr << "Error: the regions pattern needs two regions [top left, bottom right] and 0 <= rate <= rate_max <= 1" << endl;
+	return false;
+    }
+
+    vector < int > region[2];
+    const vector < int > * corners[2] = { &pattern.src_region, &pattern.dst_region };
+    for (int r = 0; r < 2; r++)
+    {
+	int tl = (*corners[r])[0];
+	int br = (*corners[r])[1];
+	if (tl < 0 || br >= n_nodes || tl % dim_x > br % dim_x || tl / dim_x > br / dim_x)
+	{
+	    cerr << "Error: invalid region " << tl << " " << br << endl;
+	    return false;
+	}
+
+	for (int y = tl / dim_x; y <= br / dim_x; y++)
+	    for (int x = tl % dim_x; x <= br % dim_x; x++)
+		region[r].push_back(y * dim_x + x);
+    }
+
+    for (unsigned int s = 0; s < region[0].size(); s++)
+	for (unsigned int d = 0; d < region[1].size(); d++)
+	    if ((double) rand() / RAND_MAX < pattern.fraction && region[0][s] != region[1][d])
+		addCommunication(region[0][s], region[1][d],
+				 (double) rand() / RAND_MAX * (pattern.rate_max - pattern.rate) + pattern.rate);
+
+    return true;
+}
+
+bool TrafficTableGenerator::distanceBased(const TrafficPattern & pattern)
+{
+    if (pattern.communications < 0 || pattern.distance < 1 ||
+	pattern.fraction < 0.0 || pattern.fraction > 1.0 || pattern.rate < 0.0 || pattern.rate > 1.0)
+    {
+	cerr << "Error: the distance pattern needs communications >= 0, distance >= 1, fraction in [0,1] and rate in [0,1]" << endl;
+	return false;
+    }
+
+    int short_range = (int) (pattern.communications * pattern.fraction);
+
+    for (int i = 0; i < pattern.communications; i++)
+    {
+	int src = rand() % n_nodes;
+	int dst = randomNode(src, pattern.distance, i < short_range);
+	if (dst < 0)
+	{
+	    cerr << "Error: node " << src << " has no " << (i < short_range ? "short" : "long")
+		 << " range destination at distance " << pattern.distance << endl;
+	    return false;
+	}
+	addCommunication(src, dst, pattern.rate);
+    }
+
+    return true;
+}
+
+// Random node within (short_range) or beyond distance hops from center,
+// -1 if there is none
+int TrafficTableGenerator::randomNode(const int center, const int distance, const bool short_range) const
+{
+    vector < int > candidates;
+
+    for (int node = 0; node < n_nodes; node++)
+    {
+	int hops = abs(node % dim_x - center % dim_x) + abs(node / dim_x - center / dim_x);
+	if (node != center && (hops <= distance) == short_range)
+	    candidates.push_back(node);
+    }
+
+    if (candidates.empty())
+	return -1;
+
+    return candidates[rand() % candidates.size()];
+}
+
+void TrafficTableGenerator::writeText(ostream & out) const
+{
+    for (unsigned int i = 0; i < table.size(); i++)
+	out << table[i].src << "\t" << table[i].dst << "\t" << table[i].pir << endl;
+}
+
+bool TrafficTableGenerator::writeBinary(const char *fname) const
+{
+    FILE *fout = fopen(fname, "wb");
+    if (fout == NULL)
+    {
+	cerr << "Error: cannot create " << fname << endl;
+	return false;
+    }
+
+    TrafficTableHeader header;
+    memcpy(header.magic, TRAFFIC_TABLE_MAGIC, sizeof(header.magic));
+    header.version = TRAFFIC_TABLE_VERSION;
+    header.n_communications = table.size();
+
+    bool ok = (fwrite(&header, sizeof(header), 1, fout) == 1 &&
+	       (table.empty() || fwrite(&table[0], sizeof(Communication), table.size(), fout) == table.size()));
+    ok = (fclose(fout) == 0) && ok;
+
+    if (!ok)
+	cerr << "Error: cannot write " << fname << endl;
+
+    return ok;
+}
@@ -0,0 +1,110 @@
+/*
+ * Noxim - the NoC Simulator
+ *
+ * (C) 2005-2018 by the University of Catania
+ * For the complete list of authors refer to file ../doc/AUTHORS.txt
+ * For the license applied to these sources refer to file ../doc/LICENSE.txt
+ *
+ * This file contains the declaration of the traffic table generator,
+ * shared by the simulator and other/ttable_gen.cpp
+ */
+
+#ifndef __NOXIMTRAFFICTABLEGENERATOR_H__
+#define __NOXIMTRAFFICTABLEGENERATOR_H__
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Structure used to store information into the table
+struct Communication {
+  int src;			// ID of the source node (PE)
+  int dst;			// ID of the destination node (PE)
+  double pir;			// Packet Injection Rate for the link
+  double por;			// Probability Of Retransmission for the link
+  int t_on;			// Time (in cycles) at which activity begins
+  int t_off;			// Time (in cycles) at which activity ends
+  int t_period;		        // Period after which activity starts again
+  int traffic_class;		// QoS class of the packets (0 is the most urgent)
+};
+
+// Binary traffic table: a TrafficTableHeader followed by n_communications
+// Communication records, in native byte order
+#define TRAFFIC_TABLE_MAGIC	"NXTT"
+#define TRAFFIC_TABLE_VERSION	1
+
+// t_off and t_period of a communication lasting the whole simulation
+#define TRAFFIC_TABLE_FOREVER	-1
+
+struct TrafficTableHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t n_communications;
+};
+
+// Traffic patterns
+#define PATTERN_UNIFORM		"uniform"	// every node to every other node
+#define PATTERN_HOTSPOT		"hotspot"	// a fraction of the traffic to the hotspot nodes, uniform otherwise
+#define PATTERN_TRANSPOSE1	"transpose1"
+#define PATTERN_TRANSPOSE2	"transpose2"
+#define PATTERN_BIT_REVERSAL	"bitreversal"
+#define PATTERN_SHUFFLE		"shuffle"
+#define PATTERN_BUTTERFLY	"butterfly"
+#define PATTERN_REGIONS		"regions"	// random pairs between two mesh regions (as hotspot_ttable)
+#define PATTERN_DISTANCE	"distance"	// short/long range random pairs (as distancebased_ttable)
+
+// A pattern of a traffic table, tables mixing several patterns being
+// the union of their communications
+struct TrafficPattern {
+    string pattern;
+    double rate;		// packets/cycle injected by each source (pir of each pair for regions/distance)
+    double rate_max;		// regions: pir drawn in [rate, rate_max]
+    vector < int > nodes;	// hotspot nodes
+    double fraction;		// hotspot: traffic to the hotspots. regions: probability of a pair.
+				// distance: fraction of short range communications
+    vector < int > src_region;	// regions: [top left, bottom right] node
+    vector < int > dst_region;
+    int communications;		// distance: number of communications
+    int distance;		// distance: hops discriminating short and long range
+
+    TrafficPattern() {
+	rate = rate_max = fraction = 0.0;
+	communications = distance = 0;
+    }
+};
+
+class TrafficTableGenerator {
+
+  public:
+
+    // Mesh of dim_x * dim_y nodes. Communications are of class 0 and
+    // always active: t_on is 0, t_off and t_period are TRAFFIC_TABLE_FOREVER
+    TrafficTableGenerator(const int dim_x, const int dim_y);
+
+    // Appends the communications of pattern to the table. Returns false,
+    // with a message on cerr, if the pattern is invalid
+    bool add(const TrafficPattern & pattern);
+
+    const vector < Communication > & getTable() const { return table; }
+
+    // Text (as read by GlobalTrafficTable::load) and binary output
+    void writeText(ostream & out) const;
+    bool writeBinary(const char *fname) const;
+
+  private:
+
+    void addCommunication(const int src, const int dst, const double pir);
+    bool permutation(const string & pattern, const double rate);
+    int permutationDestination(const string & pattern, const int src) const;
+    bool regions(const TrafficPattern & pattern);
+    bool distanceBased(const TrafficPattern & pattern);
+    int randomNode(const int center, const int distance, const bool short_range) const;
+
+    int dim_x, dim_y, n_nodes;
+    vector < Communication > table;
+};
+
+#endif
@@ -128,7 +128,7 @@ inline ostream & operator <<(ostream & os, const TBufferFullStatus & bfs)
     for (int j = 0; j < GlobalParams::n_virtual_channels; j++)
 	os << bfs.mask[j] << " ";
 
-    os << "]" << endl;
+    os << "] credit " << bfs.credit_seq << "@" << bfs.credit_vc << endl;
     return os;
 }
 
@@ -158,6 +158,7 @@ inline void sc_trace(sc_trace_file * &tf, const TBufferFullStatus & bfs, string
 {
     for (int j = 0; j < GlobalParams::n_virtual_channels; j++)
 	sc_trace(tf, bfs.mask[j], name + "VC "+to_string(j));
+    sc_trace(tf, bfs.credit_seq, name + ".credit_seq");
 }
 
 inline void sc_trace(sc_trace_file * &tf, const ChannelStatus & bs, string & name)
@@ -235,6 +236,34 @@ inline int tile2Hub(int id)
     return it->second;
 }
 
+// Injection probability of the MMPP state s: the relative state rates
+// are scaled so that the time average is rate, the packet injection
+// rate of the PE. The time spent in each state is proportional to its
+// sojourn, as the next state is uniformly chosen among the others
+inline double mmppStateRate(const int s, const double rate)
+{
+    double weighted = 0.0;
+    double time = 0.0;
+
+    for (unsigned int i = 0; i < GlobalParams::mmpp_state_rates.size(); i++)
+    {
+	weighted += GlobalParams::mmpp_state_rates[i] * GlobalParams::mmpp_state_sojourn[i];
+	time += GlobalParams::mmpp_state_sojourn[i];
+    }
+
+    return rate * GlobalParams::mmpp_state_rates[s] * time / weighted;
+}
+
+// Lowest node of a multicast destination set, NOT_VALID if empty
+inline int firstDestination(const DestinationSet & dst_set)
+{
+    for (int id = 0; id < MAX_MULTICAST_NODES; id++)
+	if (dst_set[id])
+	    return id;
+
+    return NOT_VALID;
+}
+
 
 inline void printMap(string label, const map<string,double> & m,std::ostream & out)
 {
@@ -0,0 +1,90 @@
+#ifndef __NOXIMALLOCATOR_H__
+#define __NOXIMALLOCATOR_H__
+
+#include <vector>
+#include "../DataStructs.h"
+#include "../Utils.h"
+
+using namespace std;
+
+// A reserved input/VC asking for its output port in the current cycle
+struct AllocRequest
+{
+    int input;
+    int vc;
+    int output;
+    int out_vc;   // VC allocated on the output
+    bool ready;   // flit available and room downstream
+    bool current; // highest priority reservation of the output (see ReservationTable::updateIndex)
+    int traffic_class; // QoS class of the waiting flit (0 is the most urgent)
+    double timestamp;  // generation time of the packet of the waiting flit
+
+    AllocRequest() : traffic_class(0), timestamp(0.0) { }
+
+    // takes the priority fields from the flit waiting for the output
+    void setPriority(const Flit & flit)
+    {
+	traffic_class = flit.traffic_class;
+	timestamp = flit.timestamp;
+    }
+};
+
+// Round-robin pointers kept by each router/hub across cycles
+struct AllocatorState
+{
+    int n_inputs;
+    int n_outputs;
+    int n_vcs;
+    vector<int> grant_ptr;  // for each output, input having the highest priority
+    vector<int> accept_ptr; // for each input, output having the highest priority
+    vector<int> vc_ptr;     // for each input, VC having the highest priority
+
+    void setSize(int inputs, int outputs, int vcs)
+    {
+	n_inputs = inputs;
+	n_outputs = outputs;
+	n_vcs = vcs;
+	grant_ptr.assign(outputs, 0);
+	accept_ptr.assign(inputs, 0);
+	vc_ptr.assign(inputs, 0);
+    }
+};
+
+class Allocator
+{
+	public:
+	// Returns the requests granted in the current cycle, at most one
+	// for each input and for each output
+        virtual vector<AllocRequest> allocate(AllocatorState & state, const vector<AllocRequest> & requests) = 0;
+
+	protected:
+	// Returns the candidate closest to ptr, scanning modulo n
+	static int roundRobin(const vector<int> & candidates, int ptr, int n)
+	{
+	    int best = NOT_VALID;
+	    for (unsigned int i = 0; i < candidates.size(); i++)
+		if (best == NOT_VALID || (candidates[i] - ptr + n) % n < (best - ptr + n) % n)
+		    best = candidates[i];
+	    return best;
+	}
+
+	// Returns the index of the ready request of input towards output
+	// whose VC is the closest to the input VC pointer
+	static int selectVC(const AllocatorState & state, const vector<AllocRequest> & requests, int input, int output)
+	{
+	    vector<int> vcs;
+	    for (unsigned int r = 0; r < requests.size(); r++)
+		if (requests[r].ready && requests[r].input == input && requests[r].output == output)
+		    vcs.push_back(requests[r].vc);
+
+	    int vc = roundRobin(vcs, state.vc_ptr[input], state.n_vcs);
+
+	    for (unsigned int r = 0; r < requests.size(); r++)
+		if (requests[r].ready && requests[r].input == input && requests[r].output == output && requests[r].vc == vc)
+		    return r;
+
+	    return NOT_VALID;
+	}
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include "Allocator_AGE.h"
+#include <algorithm>
+
+AllocatorsRegister Allocator_AGE::allocatorsRegister("AGE", getInstance());
+
+Allocator_AGE * Allocator_AGE::allocator_AGE = 0;
+
+Allocator_AGE * Allocator_AGE::getInstance() {
+	if ( allocator_AGE == 0 )
+		allocator_AGE = new Allocator_AGE();
+    
+	return allocator_AGE;
+}
+
+// Orders request indexes by traffic class, then by packet age, then
+// round-robin on the output grant pointer
+struct OlderFirst
+{
+    const AllocatorState & state;
+    const vector<AllocRequest> & requests;
+
+    OlderFirst(const AllocatorState & s, const vector<AllocRequest> & r) : state(s), requests(r) { }
+
+    int distance(const AllocRequest & r) const
+    {
+	return (r.input - state.grant_ptr[r.output] + state.n_inputs) % state.n_inputs;
+    }
+
+    bool operator()(int a, int b) const
+    {
+	const AllocRequest & ra = requests[a];
+	const AllocRequest & rb = requests[b];
+
+	if (ra.traffic_class != rb.traffic_class)
+	    return ra.traffic_class < rb.traffic_class;
+	if (ra.timestamp != rb.timestamp)
+	    return ra.timestamp < rb.timestamp;
+	return distance(ra) < distance(rb);
+    }
+};
+
+// Priority allocation: ready requests are served greedily from the most
+// urgent QoS class and, inside a class, from the oldest packet, so that
+// packets coming from far away are not starved near saturation.
+vector<AllocRequest> Allocator_AGE::allocate(AllocatorState & state, const vector<AllocRequest> & requests)
+{
+    vector<AllocRequest> grants;
+    vector<int> order;
+
+    for (unsigned int r = 0; r < requests.size(); r++)
+	if (requests[r].ready)
+	    order.push_back(r);
+
+    sort(order.begin(), order.end(), OlderFirst(state, requests));
+
+    vector<bool> input_granted(state.n_inputs, false);
+    vector<bool> output_granted(state.n_outputs, false);
+
+    for (unsigned int k = 0; k < order.size(); k++)
+    {
+	const AllocRequest & request = requests[order[k]];
+
+	if (input_granted[request.input] || output_granted[request.output])
+	    continue;
+
+	grants.push_back(request);
+	input_granted[request.input] = true;
+	output_granted[request.output] = true;
+
+	state.grant_ptr[request.output] = (request.input + 1) % state.n_inputs;
+	state.vc_ptr[request.input] = (request.vc + 1) % state.n_vcs;
+    }
+
+    return grants;
+}
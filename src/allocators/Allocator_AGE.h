@@ -0,0 +1,23 @@
+#ifndef __NOXIMALLOCATOR_AGE_H__
+#define __NOXIMALLOCATOR_AGE_H__
+
+#include "Allocator.h"
+#include "Allocators.h"
+
+using namespace std;
+
+class Allocator_AGE : Allocator {
+	public:
+        vector<AllocRequest> allocate(AllocatorState & state, const vector<AllocRequest> & requests);
+
+		static Allocator_AGE * getInstance();
+
+	private:
+		Allocator_AGE(){};
+		~Allocator_AGE(){};
+
+		static Allocator_AGE * allocator_AGE;
+		static AllocatorsRegister allocatorsRegister;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "Allocator_INPUT_FIRST.h"
+
+AllocatorsRegister Allocator_INPUT_FIRST::allocatorsRegister("INPUT_FIRST", getInstance());
+
+Allocator_INPUT_FIRST * Allocator_INPUT_FIRST::allocator_INPUT_FIRST = 0;
+
+Allocator_INPUT_FIRST * Allocator_INPUT_FIRST::getInstance() {
+	if ( allocator_INPUT_FIRST == 0 )
+		allocator_INPUT_FIRST = new Allocator_INPUT_FIRST();
+    
+	return allocator_INPUT_FIRST;
+}
+
+// Separable input-first allocation: every input selects one of its
+// ready VCs (round-robin), then every output grants one of the
+// selecting inputs (round-robin). Pointers only advance on grants.
+vector<AllocRequest> Allocator_INPUT_FIRST::allocate(AllocatorState & state, const vector<AllocRequest> & requests)
+{
+    vector<AllocRequest> grants;
+    vector<int> selected(state.n_inputs, NOT_VALID);
+
+    for (int i = 0; i < state.n_inputs; i++)
+    {
+	vector<int> vcs;
+	for (unsigned int r = 0; r < requests.size(); r++)
+	    if (requests[r].ready && requests[r].input == i)
+		vcs.push_back(requests[r].vc);
+
+	int vc = roundRobin(vcs, state.vc_ptr[i], state.n_vcs);
+
+	for (unsigned int r = 0; r < requests.size(); r++)
+	    if (requests[r].ready && requests[r].input == i && requests[r].vc == vc)
+		selected[i] = r;
+    }
+
+    for (int o = 0; o < state.n_outputs; o++)
+    {
+	vector<int> inputs;
+	for (int i = 0; i < state.n_inputs; i++)
+	    if (selected[i] != NOT_VALID && requests[selected[i]].output == o)
+		inputs.push_back(i);
+
+	int i = roundRobin(inputs, state.grant_ptr[o], state.n_inputs);
+	if (i == NOT_VALID)
+	    continue;
+
+	const AllocRequest & request = requests[selected[i]];
+	grants.push_back(request);
+
+	state.grant_ptr[o] = (i + 1) % state.n_inputs;
+	state.vc_ptr[i] = (request.vc + 1) % state.n_vcs;
+    }
+
+    return grants;
+}
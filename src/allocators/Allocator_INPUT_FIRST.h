@@ -0,0 +1,23 @@
+#ifndef __NOXIMALLOCATOR_INPUT_FIRST_H__
+#define __NOXIMALLOCATOR_INPUT_FIRST_H__
+
+#include "Allocator.h"
+#include "Allocators.h"
+
+using namespace std;
+
+class Allocator_INPUT_FIRST : Allocator {
+	public:
+        vector<AllocRequest> allocate(AllocatorState & state, const vector<AllocRequest> & requests);
+
+		static Allocator_INPUT_FIRST * getInstance();
+
+	private:
+		Allocator_INPUT_FIRST(){};
+		~Allocator_INPUT_FIRST(){};
+
+		static Allocator_INPUT_FIRST * allocator_INPUT_FIRST;
+		static AllocatorsRegister allocatorsRegister;
+};
+
+#endif
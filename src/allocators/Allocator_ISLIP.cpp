@@ -0,0 +1,78 @@
+#include "Allocator_ISLIP.h"
+
+AllocatorsRegister Allocator_ISLIP::allocatorsRegister("ISLIP", getInstance());
+
+Allocator_ISLIP * Allocator_ISLIP::allocator_ISLIP = 0;
+
+Allocator_ISLIP * Allocator_ISLIP::getInstance() {
+	if ( allocator_ISLIP == 0 )
+		allocator_ISLIP = new Allocator_ISLIP();
+    
+	return allocator_ISLIP;
+}
+
+// iSLIP: request-grant-accept iterations over the unmatched inputs and
+// outputs. Grant and accept pointers are only updated by the matches
+// found in the first iteration, which avoids starvation.
+vector<AllocRequest> Allocator_ISLIP::allocate(AllocatorState & state, const vector<AllocRequest> & requests)
+{
+    vector<AllocRequest> grants;
+    vector<bool> input_matched(state.n_inputs, false);
+    vector<bool> output_matched(state.n_outputs, false);
+
+    for (int iteration = 0; iteration < GlobalParams::islip_iterations; iteration++)
+    {
+	// grant
+	vector<int> granted_input(state.n_outputs, NOT_VALID);
+
+	for (int o = 0; o < state.n_outputs; o++)
+	{
+	    if (output_matched[o])
+		continue;
+
+	    vector<int> inputs;
+	    for (unsigned int r = 0; r < requests.size(); r++)
+		if (requests[r].ready && requests[r].output == o && !input_matched[requests[r].input])
+		    inputs.push_back(requests[r].input);
+
+	    granted_input[o] = roundRobin(inputs, state.grant_ptr[o], state.n_inputs);
+	}
+
+	// accept
+	bool new_matches = false;
+
+	for (int i = 0; i < state.n_inputs; i++)
+	{
+	    if (input_matched[i])
+		continue;
+
+	    vector<int> outputs;
+	    for (int o = 0; o < state.n_outputs; o++)
+		if (granted_input[o] == i)
+		    outputs.push_back(o);
+
+	    int o = roundRobin(outputs, state.accept_ptr[i], state.n_outputs);
+	    if (o == NOT_VALID)
+		continue;
+
+	    const AllocRequest & request = requests[selectVC(state, requests, i, o)];
+	    grants.push_back(request);
+
+	    input_matched[i] = true;
+	    output_matched[o] = true;
+	    new_matches = true;
+
+	    if (iteration == 0)
+	    {
+		state.grant_ptr[o] = (i + 1) % state.n_inputs;
+		state.accept_ptr[i] = (o + 1) % state.n_outputs;
+	    }
+	    state.vc_ptr[i] = (request.vc + 1) % state.n_vcs;
+	}
+
+	if (!new_matches)
+	    break;
+    }
+
+    return grants;
+}
@@ -0,0 +1,23 @@
+#ifndef __NOXIMALLOCATOR_ISLIP_H__
+#define __NOXIMALLOCATOR_ISLIP_H__
+
+#include "Allocator.h"
+#include "Allocators.h"
+
+using namespace std;
+
+class Allocator_ISLIP : Allocator {
+	public:
+        vector<AllocRequest> allocate(AllocatorState & state, const vector<AllocRequest> & requests);
+
+		static Allocator_ISLIP * getInstance();
+
+	private:
+		Allocator_ISLIP(){};
+		~Allocator_ISLIP(){};
+
+		static Allocator_ISLIP * allocator_ISLIP;
+		static AllocatorsRegister allocatorsRegister;
+};
+
+#endif
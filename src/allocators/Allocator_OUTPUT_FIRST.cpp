@@ -0,0 +1,55 @@
+#include "Allocator_OUTPUT_FIRST.h"
+
+AllocatorsRegister Allocator_OUTPUT_FIRST::allocatorsRegister("OUTPUT_FIRST", getInstance());
+
+Allocator_OUTPUT_FIRST * Allocator_OUTPUT_FIRST::allocator_OUTPUT_FIRST = 0;
+
+Allocator_OUTPUT_FIRST * Allocator_OUTPUT_FIRST::getInstance() {
+	if ( allocator_OUTPUT_FIRST == 0 )
+		allocator_OUTPUT_FIRST = new Allocator_OUTPUT_FIRST();
+    
+	return allocator_OUTPUT_FIRST;
+}
+
+// Separable output-first allocation: every output grants one of the
+// inputs having a ready VC for it (round-robin), then every input
+// accepts one of the granting outputs (round-robin). Pointers only
+// advance on accepted grants.
+vector<AllocRequest> Allocator_OUTPUT_FIRST::allocate(AllocatorState & state, const vector<AllocRequest> & requests)
+{
+    vector<AllocRequest> grants;
+    vector<int> granted(state.n_outputs, NOT_VALID);
+
+    for (int o = 0; o < state.n_outputs; o++)
+    {
+	vector<int> inputs;
+	for (unsigned int r = 0; r < requests.size(); r++)
+	    if (requests[r].ready && requests[r].output == o)
+		inputs.push_back(requests[r].input);
+
+	int i = roundRobin(inputs, state.grant_ptr[o], state.n_inputs);
+	if (i != NOT_VALID)
+	    granted[o] = selectVC(state, requests, i, o);
+    }
+
+    for (int i = 0; i < state.n_inputs; i++)
+    {
+	vector<int> outputs;
+	for (int o = 0; o < state.n_outputs; o++)
+	    if (granted[o] != NOT_VALID && requests[granted[o]].input == i)
+		outputs.push_back(o);
+
+	int o = roundRobin(outputs, state.accept_ptr[i], state.n_outputs);
+	if (o == NOT_VALID)
+	    continue;
+
+	const AllocRequest & request = requests[granted[o]];
+	grants.push_back(request);
+
+	state.accept_ptr[i] = (o + 1) % state.n_outputs;
+	state.grant_ptr[o] = (i + 1) % state.n_inputs;
+	state.vc_ptr[i] = (request.vc + 1) % state.n_vcs;
+    }
+
+    return grants;
+}
@@ -0,0 +1,23 @@
+#ifndef __NOXIMALLOCATOR_OUTPUT_FIRST_H__
+#define __NOXIMALLOCATOR_OUTPUT_FIRST_H__
+
+#include "Allocator.h"
+#include "Allocators.h"
+
+using namespace std;
+
+class Allocator_OUTPUT_FIRST : Allocator {
+	public:
+        vector<AllocRequest> allocate(AllocatorState & state, const vector<AllocRequest> & requests);
+
+		static Allocator_OUTPUT_FIRST * getInstance();
+
+	private:
+		Allocator_OUTPUT_FIRST(){};
+		~Allocator_OUTPUT_FIRST(){};
+
+		static Allocator_OUTPUT_FIRST * allocator_OUTPUT_FIRST;
+		static AllocatorsRegister allocatorsRegister;
+};
+
+#endif
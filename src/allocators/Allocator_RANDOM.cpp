@@ -0,0 +1,39 @@
+#include "Allocator_RANDOM.h"
+
+AllocatorsRegister Allocator_RANDOM::allocatorsRegister("RANDOM", getInstance());
+
+Allocator_RANDOM * Allocator_RANDOM::allocator_RANDOM = 0;
+
+Allocator_RANDOM * Allocator_RANDOM::getInstance() {
+	if ( allocator_RANDOM == 0 )
+		allocator_RANDOM = new Allocator_RANDOM();
+    
+	return allocator_RANDOM;
+}
+
+// Each input forwards one of the outputs whose current reservation
+// belongs to it, chosen at random. Only the current reservation of an
+// output is considered, so the output index rotation performed by
+// ReservationTable::updateIndex decides which VC can be served.
+vector<AllocRequest> Allocator_RANDOM::allocate(AllocatorState & state, const vector<AllocRequest> & requests)
+{
+    vector<AllocRequest> grants;
+
+    for (int i = 0; i < state.n_inputs; i++)
+    {
+	vector<int> current;
+	for (unsigned int r = 0; r < requests.size(); r++)
+	    if (requests[r].input == i && requests[r].current)
+		current.push_back(r);
+
+	if (current.size() == 0)
+	    continue;
+
+	const AllocRequest & request = requests[current[rand() % current.size()]];
+
+	if (request.ready)
+	    grants.push_back(request);
+    }
+
+    return grants;
+}
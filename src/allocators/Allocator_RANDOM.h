@@ -0,0 +1,23 @@
+#ifndef __NOXIMALLOCATOR_RANDOM_H__
+#define __NOXIMALLOCATOR_RANDOM_H__
+
+#include "Allocator.h"
+#include "Allocators.h"
+
+using namespace std;
+
+class Allocator_RANDOM : Allocator {
+	public:
+        vector<AllocRequest> allocate(AllocatorState & state, const vector<AllocRequest> & requests);
+
+		static Allocator_RANDOM * getInstance();
+
+	private:
+		Allocator_RANDOM(){};
+		~Allocator_RANDOM(){};
+
+		static Allocator_RANDOM * allocator_RANDOM;
+		static AllocatorsRegister allocatorsRegister;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#include "Allocators.h"
+
+AllocatorsMap * Allocators::allocatorsMap = 0;
+
+Allocator * Allocators::get(const string & allocatorName) {
+	AllocatorsMap::iterator it = getAllocatorsMap()->find(allocatorName);
+
+	if(it == getAllocatorsMap()->end())
+		return 0;
+
+	return it->second;
+}
+
+AllocatorsMap * Allocators::getAllocatorsMap() {
+	if(allocatorsMap == 0) 
+		allocatorsMap = new AllocatorsMap();
+	return allocatorsMap; 
+}
@@ -0,0 +1,26 @@
+#ifndef __NOXIMALLOCATORS_H__
+#define __NOXIMALLOCATORS_H__
+
+#include <map>
+#include <string>
+#include "Allocator.h"
+
+using namespace std;
+
+typedef map<string, Allocator* > AllocatorsMap;
+
+class Allocators {
+	public:
+		static AllocatorsMap * allocatorsMap;
+		static AllocatorsMap * getAllocatorsMap();
+
+		static Allocator * get(const string & allocatorName);
+};
+
+struct AllocatorsRegister : Allocators {
+	AllocatorsRegister(const string & allocatorName, Allocator * allocator) {
+		getAllocatorsMap()->insert(make_pair(allocatorName, allocator));
+	}
+};
+
+#endif
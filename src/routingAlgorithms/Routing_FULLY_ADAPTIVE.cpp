@@ -0,0 +1,33 @@
+#include "Routing_FULLY_ADAPTIVE.h"
+
+RoutingAlgorithmsRegister Routing_FULLY_ADAPTIVE::routingAlgorithmsRegister("FULLY_ADAPTIVE", getInstance());
+
+Routing_FULLY_ADAPTIVE * Routing_FULLY_ADAPTIVE::routing_FULLY_ADAPTIVE = 0;
+
+Routing_FULLY_ADAPTIVE * Routing_FULLY_ADAPTIVE::getInstance() {
+	if ( routing_FULLY_ADAPTIVE == 0 )
+		routing_FULLY_ADAPTIVE = new Routing_FULLY_ADAPTIVE();
+    
+	return routing_FULLY_ADAPTIVE;
+}
+
+// All the minimal directions. Deadlock freedom comes from the escape
+// VC, see Router::adaptiveRoute()
+vector<int> Routing_FULLY_ADAPTIVE::route(Router * router, const RouteData & routeData)
+{
+    Coord current = id2Coord(routeData.current_id);
+    Coord destination = id2Coord(routeData.dst_id);
+    vector <int> directions;
+
+    if (destination.x > current.x)
+        directions.push_back(DIRECTION_EAST);
+    else if (destination.x < current.x)
+        directions.push_back(DIRECTION_WEST);
+
+    if (destination.y > current.y)
+        directions.push_back(DIRECTION_SOUTH);
+    else if (destination.y < current.y)
+        directions.push_back(DIRECTION_NORTH);
+
+    return directions;
+}
@@ -0,0 +1,92 @@
+#include "Selection_RCA.h"
+
+SelectionStrategiesRegister Selection_RCA::selectionStrategiesRegister("RCA", getInstance());
+
+Selection_RCA * Selection_RCA::selection_RCA = 0;
+
+Selection_RCA * Selection_RCA::getInstance() {
+	if ( selection_RCA == 0 )
+		selection_RCA = new Selection_RCA();
+    
+	return selection_RCA;
+}
+
+int Selection_RCA::apply(Router * router, const vector < int >&directions, const RouteData & route_data) {
+    assert(directions.size()!=0);
+
+    if (directions.size()==1) return directions[0];
+
+    // the least congested region wins, ties are broken randomly
+    vector < int >best_directions;
+    int best_load = 0;
+
+    for (size_t i = 0; i < directions.size(); i++)
+    {
+	int d = directions[i];
+	int load = 0;
+
+	if (d < DIRECTIONS)
+	{
+	    load = router->NoP_data_in[d].read().rca_load[d];
+
+	    // an output with all its VCs already taken is worse than any
+	    // regional estimate
+	    bool free_vc = false;
+	    for (int vc = 0; vc < GlobalParams::n_virtual_channels && !free_vc; vc++)
+		free_vc = router->reservation_table.isNotReserved(d, vc);
+	    if (!free_vc)
+		load += 1000;
+	}
+
+	if (best_directions.empty() || load < best_load)
+	{
+	    best_directions.clear();
+	    best_load = load;
+	}
+	if (load == best_load)
+	    best_directions.push_back(d);
+    }
+
+    return best_directions[rand() % best_directions.size()];
+}
+
+int Selection_RCA::inputLoad(Router * router, int port) {
+    int occupied = 0;
+    int capacity = 0;
+
+    for (int vc = 0; vc < GlobalParams::n_virtual_channels; vc++)
+    {
+	occupied += router->buffer[port][vc].Size();
+	capacity += GlobalParams::buffer_depth;
+    }
+
+    if (capacity == 0) return 0;
+    if (occupied > capacity) occupied = capacity;
+
+    return (1000 * occupied) / capacity;
+}
+
+void Selection_RCA::perCycleUpdate(Router * router) {
+	    // update current input buffers level to neighbors
+	    for (int i = 0; i < DIRECTIONS + 1; i++)
+		router->free_slots[i].write(router->buffer[i][DEFAULT_VC].getCurrentFreeSlots());
+
+	    NoP_data current_NoP_data = router->getCurrentNoPData();
+
+	    // A packet travelling in direction d enters this router from
+	    // reflex(d): blend that input's load with the regional estimate
+	    // coming from the next router along d
+	    for (int d = 0; d < DIRECTIONS; d++)
+	    {
+		int local = inputLoad(router, router->reflexDirection(d));
+
+		NoP_data downstream = router->NoP_data_in[d].read();
+		int remote = (downstream.sender_id == NOT_VALID) ? 0 : downstream.rca_load[d];
+
+		current_NoP_data.rca_load[d] = (int)((1.0 - GlobalParams::rca_weight) * local +
+						      GlobalParams::rca_weight * remote);
+	    }
+
+	    for (int i = 0; i < DIRECTIONS; i++)
+		router->NoP_data_out[i].write(current_NoP_data);
+}
@@ -0,0 +1,32 @@
+#ifndef __NOXIMSELECTION_RCA_H__
+#define __NOXIMSELECTION_RCA_H__
+
+#include "SelectionStrategy.h"
+#include "SelectionStrategies.h"
+#include "../Router.h"
+
+using namespace std;
+
+// Regional Congestion Awareness: each router propagates, along every
+// dimension, a congestion estimate that blends the load of its own
+// input buffers with the estimate received from the next router in the
+// same direction, so that remote hops weigh geometrically less.
+class Selection_RCA : SelectionStrategy {
+	public:
+        int apply(Router * router, const vector < int >&directions, const RouteData & route_data);
+        void perCycleUpdate(Router * router);
+
+		static Selection_RCA * getInstance();
+
+	private:
+		Selection_RCA(){};
+		~Selection_RCA(){};
+
+		// Occupancy of all the VCs of an input port, in per-mille
+		int inputLoad(Router * router, int port);
+
+		static Selection_RCA * selection_RCA;
+		static SelectionStrategiesRegister selectionStrategiesRegister;
+};
+
+#endif